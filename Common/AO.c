@@ -0,0 +1,186 @@
+// AO.c
+// Runs on LM4F120/TM4C123
+// Active objects: each component owns a queue of events and
+// a dispatch function that handles one event to completion.
+// Events come from a pool of fixed-size blocks, interrupt
+// handlers and other objects post them, AO_Run() hands them
+// out in priority order and sleeps when every queue is empty.
+// Enes Kur
+// October 18, 2026
+
+#include "AO.h"
+#include "Clock.h"
+
+#define NVIC_DEMCR_R            (*((volatile unsigned long *)0xE000EDFC))
+#define NVIC_DEMCR_TRCENA       0x01000000  // Trace system enable
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Cycle counter enable
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+void DisableInterrupts(void); // Disable interrupts
+void EnableInterrupts(void);  // Enable interrupts
+void WaitForInterrupt(void);  // low power mode
+
+unsigned long AO_Lost;
+unsigned long AO_PoolMin;
+unsigned long AO_Load[AO_MAXOBJECTS];
+unsigned long AO_IdleLoad;
+unsigned long AO_MaxCycles[AO_MAXOBJECTS];
+
+static struct AO_Event Pool[AO_POOLSIZE];
+static struct AO_Event *Free;						// free list
+static unsigned long NumFree;
+static struct AO_Object *Objects[AO_MAXOBJECTS];
+static unsigned long NumObjects;
+static unsigned long Busy[AO_MAXOBJECTS];		// cycles in this window
+static unsigned long WindowStart;						// cycle count the window started
+
+//------------AO_Init------------
+// Fill the event pool, no objects, start the cycle counter
+// Input: none
+// Output: none
+void AO_Init(void){
+	unsigned long i;
+	for(i=0; i<AO_MAXOBJECTS; i++){
+		AO_Load[i] = 0;
+		AO_MaxCycles[i] = 0;
+		Busy[i] = 0;
+	}
+	AO_IdleLoad = 1000;
+	NVIC_DEMCR_R |= NVIC_DEMCR_TRCENA;	// DWT is off until trace is enabled
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+	Free = 0;
+	for(i=0; i<AO_POOLSIZE; i++){
+		Pool[i].Next = Free;
+		Free = &Pool[i];
+	}
+	NumFree = AO_POOLSIZE;
+	AO_PoolMin = AO_POOLSIZE;
+	AO_Lost = 0;
+	NumObjects = 0;
+}
+
+//------------AO_Start------------
+// Add an active object, objects started first have the
+// highest priority
+// Input: me        object, its queue starts empty
+//        dispatch  handles one event, must not wait
+//        queue     storage for size event pointers
+//        size      queue length, power of 2
+// Output: 1 if added, 0 if all AO_MAXOBJECTS are taken
+int AO_Start(struct AO_Object *me, void(*dispatch)(const struct AO_Event *e),
+             struct AO_Event **queue, unsigned long size){
+	if(NumObjects >= AO_MAXOBJECTS){
+		return 0;
+	}
+	me->Dispatch = dispatch;
+	me->Queue = queue;
+	me->Mask = size - 1;
+	me->Put = me->Get = 0;
+	Objects[NumObjects] = me;
+	NumObjects = NumObjects + 1;
+	return 1;
+}
+
+//------------AO_Post------------
+// Take a block from the pool and queue it for an object,
+// callable from handlers
+// Input: me    object to receive the event
+//        sig   signal
+//        data  parameter
+// Output: 1 if queued, 0 if dropped
+int AO_Post(struct AO_Object *me, unsigned long sig, unsigned long data){
+	struct AO_Event *e;
+	long sr;
+	sr = StartCritical();
+	if((Free == 0) || ((me->Put - me->Get) > me->Mask)){
+		AO_Lost = AO_Lost + 1;
+		EndCritical(sr);
+		return 0;
+	}
+	e = Free;
+	Free = e->Next;
+	NumFree = NumFree - 1;
+	if(NumFree < AO_PoolMin){
+		AO_PoolMin = NumFree;
+	}
+	e->Sig = sig;
+	e->Data = data;
+	me->Queue[me->Put&me->Mask] = e;
+	me->Put = me->Put + 1;
+	EndCritical(sr);
+	return 1;
+}
+
+// Turn the cycles counted in the last second into shares
+static void window(void){
+	unsigned long i, total, used;
+	total = DWT_CYCCNT_R - WindowStart;
+	used = 0;
+	for(i=0; i<NumObjects; i++){
+		AO_Load[i] = (unsigned long)(((unsigned long long)Busy[i]*1000 + total/2)/total);
+		used = used + AO_Load[i];
+		Busy[i] = 0;
+	}
+	AO_IdleLoad = (used < 1000) ? (1000 - used) : 0;
+	WindowStart = DWT_CYCCNT_R;
+}
+
+// Dispatch one event to object i and book its cycles
+static void dispatch(unsigned long i, const struct AO_Event *e){
+	unsigned long start, cycles;
+	start = DWT_CYCCNT_R;
+	(*Objects[i]->Dispatch)(e);						// to completion
+	cycles = DWT_CYCCNT_R - start;
+	Busy[i] = Busy[i] + cycles;
+	if(cycles > AO_MaxCycles[i]){
+		AO_MaxCycles[i] = cycles;
+	}
+}
+
+//------------AO_Run------------
+// Dispatch events forever, highest priority object first,
+// one event at a time; enables interrupts
+// Input: none
+// Output: none, never returns
+void AO_Run(void){
+	struct AO_Object *me;
+	struct AO_Event *e;
+	unsigned long i;
+	long sr;
+	WindowStart = DWT_CYCCNT_R;
+	EnableInterrupts();
+	while(1){
+		if((DWT_CYCCNT_R - WindowStart) >= Clock_Hz()){
+			window();
+		}
+		for(i=0; i<NumObjects; i++){
+			me = Objects[i];
+			if(me->Get != me->Put){
+				e = me->Queue[me->Get&me->Mask];
+				me->Get = me->Get + 1;						// only this loop moves Get
+				dispatch(i, e);
+				sr = StartCritical();
+				e->Next = Free;										// back to the pool
+				Free = e;
+				NumFree = NumFree + 1;
+				EndCritical(sr);
+				break;														// rescan, higher priority first
+			}
+		}
+		if(i == NumObjects){									// all queues were empty
+			DisableInterrupts();								// no post can slip in before the sleep
+			for(i=0; i<NumObjects; i++){
+				if(Objects[i]->Get != Objects[i]->Put){
+					break;
+				}
+			}
+			if(i == NumObjects){
+				WaitForInterrupt();
+			}
+			EnableInterrupts();
+		}
+	}
+}
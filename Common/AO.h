@@ -0,0 +1,79 @@
+// AO.h
+// Runs on LM4F120/TM4C123
+// Active objects: each component owns a queue of events and
+// a dispatch function that handles one event to completion.
+// Events come from a pool of fixed-size blocks, interrupt
+// handlers and other objects post them, AO_Run() hands them
+// out in priority order and sleeps when every queue is empty.
+// Enes Kur
+// October 18, 2026
+
+// An object never waits inside its dispatch function, it
+// returns and gets the next event later, so one stack serves
+// all objects and no locking is needed between them.
+// AO_Post() is safe from any handler.  Allocation and freeing
+// take a short critical section and no search: the pool is a
+// free list, a queue is a power of 2 ring of event pointers.
+// When the pool or a queue runs out the event is dropped and
+// counted in AO_Lost, the poster never blocks.
+// The cycles each object spends in its dispatch function are
+// added up with the DWT cycle counter and turned into a CPU
+// share every second of bus cycles, see AO_Load[].  Interrupt
+// handlers are not objects, their time shows up in the object
+// they interrupted or in idle.
+
+#define AO_MAXOBJECTS 6			// active objects, in priority order
+#define AO_POOLSIZE 32			// event blocks shared by all objects
+
+struct AO_Event{
+	struct AO_Event *Next;		// free list link while in the pool
+	unsigned long Sig;				// what happened, defined by the application
+	unsigned long Data;				// parameter of the signal
+};
+
+struct AO_Object{
+	void (*Dispatch)(const struct AO_Event *e);
+	struct AO_Event **Queue;	// ring storage given to AO_Start()
+	unsigned long Mask;				// ring size - 1
+	volatile unsigned long Put;
+	volatile unsigned long Get;
+};
+
+extern unsigned long AO_Lost;			// events dropped, pool empty or queue full
+extern unsigned long AO_PoolMin;	// fewest free blocks seen, headroom of AO_POOLSIZE
+extern unsigned long AO_Load[AO_MAXOBJECTS];			// CPU share over the last second, 0.1 %
+extern unsigned long AO_IdleLoad;									// time asleep or scanning, 0.1 %
+extern unsigned long AO_MaxCycles[AO_MAXOBJECTS];	// longest dispatch, bus cycles
+
+//------------AO_Init------------
+// Fill the event pool, no objects, start the cycle counter
+// Input: none
+// Output: none
+void AO_Init(void);
+
+//------------AO_Start------------
+// Add an active object, objects started first have the
+// highest priority
+// Input: me        object, its queue starts empty
+//        dispatch  handles one event, must not wait
+//        queue     storage for size event pointers
+//        size      queue length, power of 2
+// Output: 1 if added, 0 if all AO_MAXOBJECTS are taken
+int AO_Start(struct AO_Object *me, void(*dispatch)(const struct AO_Event *e),
+             struct AO_Event **queue, unsigned long size);
+
+//------------AO_Post------------
+// Take a block from the pool and queue it for an object,
+// callable from handlers
+// Input: me    object to receive the event
+//        sig   signal
+//        data  parameter
+// Output: 1 if queued, 0 if dropped
+int AO_Post(struct AO_Object *me, unsigned long sig, unsigned long data);
+
+//------------AO_Run------------
+// Dispatch events forever, highest priority object first,
+// one event at a time; enables interrupts
+// Input: none
+// Output: none, never returns
+void AO_Run(void);
@@ -0,0 +1,141 @@
+// Clock.c
+// Runs on LM4F120/TM4C123
+// System clock shared by all projects.  Clock_Init() replaces
+// the PLL_Init() each project had, 80 MHz from the PLL, and
+// Clock_Set() switches at runtime between PLL speeds, the
+// 16 MHz crystal (MOSC) and the 16 MHz internal oscillator
+// (PIOSC).  Drivers whose dividers depend on the bus clock
+// register a listener and are called after every change.
+// Enes Kur
+// October 18, 2026
+
+#include "Clock.h"
+#include "..//tm4c123gh6pm.h"
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+
+static unsigned long Hz = 16000000;		// PIOSC after reset
+static void (*Listeners[CLOCK_LISTENERS])(unsigned long hz, unsigned long oldhz);
+static unsigned long NumListeners;
+
+// Start the crystal if it was stopped for PIOSC and wait for it
+static void moscon(void){
+	if(SYSCTL_RCC_R&SYSCTL_RCC_MOSCDIS){
+		SYSCTL_MISC_R = SYSCTL_MISC_MOSCPUPMIS;	// clear the old power-up flag
+		SYSCTL_RCC_R &= ~SYSCTL_RCC_MOSCDIS;
+		while((SYSCTL_RIS_R&SYSCTL_RIS_MOSCPUPRIS)==0){};
+	}
+}
+
+//------------Clock_Init------------
+// Run from the PLL at 80 MHz with the 16 MHz crystal
+// Input: none
+// Output: none
+void Clock_Init(void){
+	Clock_Set(CLOCK_PLL, 80000000);
+}
+
+//------------Clock_Set------------
+// Change the system clock and call every listener
+// Input: source  CLOCK_PLL, CLOCK_MOSC or CLOCK_PIOSC
+//        hz      bus clock wanted from the PLL, rounded to the
+//                nearest 400 MHz/n, not used for the oscillators
+// Output: new bus clock in Hz
+unsigned long Clock_Set(unsigned long source, unsigned long hz){
+	unsigned long n, old, i;
+	long sr;
+	sr = StartCritical();
+	old = Hz;
+	SYSCTL_RCC2_R |= SYSCTL_RCC2_USERCC2;	// use RCC2
+	SYSCTL_RCC2_R |= SYSCTL_RCC2_BYPASS2;	// run from the oscillator while changing
+	if(source == CLOCK_PIOSC){
+		SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~SYSCTL_RCC2_OSCSRC2_M)+SYSCTL_RCC2_OSCSRC2_IO;
+		SYSCTL_RCC_R &= ~SYSCTL_RCC_USESYSDIV;	// undivided 16 MHz
+		SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2;		// PLL off
+		SYSCTL_RCC_R |= SYSCTL_RCC_MOSCDIS;			// crystal off
+		Hz = 16000000;
+	} else{
+		moscon();
+		SYSCTL_RCC_R = (SYSCTL_RCC_R&~SYSCTL_RCC_XTAL_M)+SYSCTL_RCC_XTAL_16MHZ;
+		SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~SYSCTL_RCC2_OSCSRC2_M)+SYSCTL_RCC2_OSCSRC2_MO;
+		if(source == CLOCK_MOSC){
+			SYSCTL_RCC_R &= ~SYSCTL_RCC_USESYSDIV;
+			SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2;
+			Hz = 16000000;
+		} else{
+			n = (400000000+hz/2)/hz;							// 400 MHz/n, nearest
+			if(n < 5){
+				n = 5;															// 80 MHz is the top speed
+			}
+			if(n > 128){
+				n = 128;														// SYSDIV2 and SYSDIV2LSB, 7 bits
+			}
+			SYSCTL_RCC2_R &= ~SYSCTL_RCC2_PWRDN2;	// PLL on
+			SYSCTL_RCC2_R |= SYSCTL_RCC2_DIV400;	// use 400 MHz PLL
+			SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~(SYSCTL_RCC2_SYSDIV2_M|SYSCTL_RCC2_SYSDIV2LSB))
+			                + ((n-1)<<22);				// divisor n-1 in SYSDIV2:SYSDIV2LSB
+			while((SYSCTL_PLLSTAT_R&SYSCTL_PLLSTAT_LOCK)==0){};
+			SYSCTL_RCC2_R &= ~SYSCTL_RCC2_BYPASS2;// enable use of PLL
+			Hz = 400000000/n;
+		}
+	}
+	for(i=0; i<NumListeners; i++){
+		(*Listeners[i])(Hz, old);
+	}
+	EndCritical(sr);
+	return Hz;
+}
+
+//------------Clock_Hz------------
+// Input: none
+// Output: current bus clock in Hz
+unsigned long Clock_Hz(void){
+	return Hz;
+}
+
+//------------Clock_AddListener------------
+// Register a function to be called, with interrupts off, after
+// each clock change.  Registering it again has no effect.
+// Input: listener  called with the new and the old bus clock in Hz
+// Output: 1 if registered, 0 if all CLOCK_LISTENERS are taken
+int Clock_AddListener(void(*listener)(unsigned long hz, unsigned long oldhz)){
+	unsigned long i;
+	for(i=0; i<NumListeners; i++){
+		if(Listeners[i] == listener){
+			return 1;
+		}
+	}
+	if(NumListeners >= CLOCK_LISTENERS){
+		return 0;
+	}
+	Listeners[NumListeners] = listener;
+	NumListeners++;
+	return 1;
+}
+
+//------------Clock_Scale------------
+// Convert a count of CLOCK_REF (80 MHz, 12.5 ns) cycles into
+// the count for the same time at the current clock, rounded.
+// Uses a 64-bit divide, for setup and clock changes.
+// Input: cycles  number of 12.5 ns periods
+// Output: number of bus cycles
+unsigned long Clock_Scale(unsigned long cycles){
+	return (unsigned long)(((unsigned long long)cycles*Hz + CLOCK_REF/2)/CLOCK_REF);
+}
+
+//------------Clock_RescaleSysTick------------
+// Listener for periodic SysTick users, keeps the interrupt
+// period in time across a clock change
+// Input: hz     new bus clock
+//        oldhz  bus clock the reload value was set for
+// Output: none
+void Clock_RescaleSysTick(unsigned long hz, unsigned long oldhz){
+	unsigned long long reload;
+	reload = ((unsigned long long)(NVIC_ST_RELOAD_R+1)*hz + oldhz/2)/oldhz;
+	if(reload > 0x01000000){
+		reload = 0x01000000;								// 24-bit counter
+	}
+	NVIC_ST_RELOAD_R = (unsigned long)reload-1;
+	NVIC_ST_CURRENT_R = 0;									// start the new period now
+}
@@ -0,0 +1,67 @@
+// Clock.h
+// Runs on LM4F120/TM4C123
+// System clock shared by all projects.  Clock_Init() replaces
+// the PLL_Init() each project had, 80 MHz from the PLL, and
+// Clock_Set() switches at runtime between PLL speeds, the
+// 16 MHz crystal (MOSC) and the 16 MHz internal oscillator
+// (PIOSC).  Drivers whose dividers depend on the bus clock
+// register a listener and are called after every change.
+// Enes Kur
+// October 18, 2026
+
+// The constants in the projects (SysTick reloads, timer periods,
+// baud rate divisors) were worked out for 80 MHz.  Clock_Scale()
+// turns such a count into the same time at the current clock.
+// With the PLL off the system clock is left at the full 16 MHz,
+// the ADC needs a 16 MHz clock whenever the PLL is bypassed.
+// Clock_Set() runs with interrupts off, the oscillator start
+// and PLL lock take up to about 0.5 ms, so interrupts never see
+// the new clock with the old dividers.
+
+#define CLOCK_PLL 0					// 400 MHz PLL divided by 5 to 128, 80 to 3.125 MHz
+#define CLOCK_MOSC 1				// 16 MHz crystal, PLL off
+#define CLOCK_PIOSC 2				// 16 MHz internal oscillator, PLL and crystal off
+#define CLOCK_REF 80000000	// bus clock the project constants were computed for
+#define CLOCK_LISTENERS 8
+
+//------------Clock_Init------------
+// Run from the PLL at 80 MHz with the 16 MHz crystal
+// Input: none
+// Output: none
+void Clock_Init(void);
+
+//------------Clock_Set------------
+// Change the system clock and call every listener
+// Input: source  CLOCK_PLL, CLOCK_MOSC or CLOCK_PIOSC
+//        hz      bus clock wanted from the PLL, rounded to the
+//                nearest 400 MHz/n, not used for the oscillators
+// Output: new bus clock in Hz
+unsigned long Clock_Set(unsigned long source, unsigned long hz);
+
+//------------Clock_Hz------------
+// Input: none
+// Output: current bus clock in Hz
+unsigned long Clock_Hz(void);
+
+//------------Clock_AddListener------------
+// Register a function to be called, with interrupts off, after
+// each clock change.  Registering it again has no effect.
+// Input: listener  called with the new and the old bus clock in Hz
+// Output: 1 if registered, 0 if all CLOCK_LISTENERS are taken
+int Clock_AddListener(void(*listener)(unsigned long hz, unsigned long oldhz));
+
+//------------Clock_Scale------------
+// Convert a count of CLOCK_REF (80 MHz, 12.5 ns) cycles into
+// the count for the same time at the current clock, rounded.
+// Uses a 64-bit divide, for setup and clock changes.
+// Input: cycles  number of 12.5 ns periods
+// Output: number of bus cycles
+unsigned long Clock_Scale(unsigned long cycles);
+
+//------------Clock_RescaleSysTick------------
+// Listener for periodic SysTick users, keeps the interrupt
+// period in time across a clock change
+// Input: hz     new bus clock
+//        oldhz  bus clock the reload value was set for
+// Output: none
+void Clock_RescaleSysTick(unsigned long hz, unsigned long oldhz);
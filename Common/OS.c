@@ -0,0 +1,415 @@
+// OS.c
+// Runs on LM4F120/TM4C123
+// Small preemptive kernel: fixed-priority threads, counting
+// semaphores and one-word mailboxes.  The context switch runs
+// in PendSV (OSasm.s) at the lowest exception priority, so an
+// interrupt handler that signals a higher priority thread
+// switches to it as soon as the handler returns.
+// Enes Kur
+// October 18, 2026
+
+#include "OS.h"
+#include "Clock.h"
+#include "..//tm4c123gh6pm.h"
+
+#define NVIC_DEMCR_R            (*((volatile unsigned long *)0xE000EDFC))
+#define NVIC_DEMCR_TRCENA       0x01000000  // Trace system enable
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Cycle counter enable
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+void DisableInterrupts(void); // Disable interrupts
+void EnableInterrupts(void);  // Enable interrupts
+void WaitForInterrupt(void);  // low power mode
+
+struct Tcb{
+	unsigned long *Sp;				// saved PSP, must be first, see OSasm.s
+	unsigned long Priority;
+	struct OS_Sema *Blocked;	// semaphore waited on, 0 if none
+	int Sleeping;							// 1 until WakeTime
+	unsigned long WakeTime;		// Timer3A count
+	int Alive;								// 0 for a free entry or a thread that returned
+};
+
+void OS_Start(struct Tcb *first);	// OSasm.s
+
+struct Tcb *RunPt;						// used by PendSV_Handler
+struct Tcb *NextPt;
+unsigned long OS_SwitchCycles;
+
+static struct Tcb Tcbs[OS_MAXTHREADS+1];	// the last entry is the idle thread
+															// 64-bit elements keep each stack top 8-byte aligned
+static unsigned long long Stacks[OS_MAXTHREADS+1][OS_STACKSIZE/2];
+static unsigned long NumThreads;
+static int Launched;
+
+// Ready to run: alive, not waiting and not sleeping
+static int ready(struct Tcb *t){
+	return t->Alive && (t->Blocked == 0) && !t->Sleeping;
+}
+
+// Pick the highest priority ready thread and pend PendSV if it
+// is not the running one.  With yield set the running thread
+// goes behind the others of its priority.  Interrupts off.
+static void schedule(int yield){
+	struct Tcb *best, *t;
+	unsigned long i, start;
+	start = (unsigned long)(RunPt - Tcbs);
+	best = 0;
+	for(i=1; i<=OS_MAXTHREADS+1; i++){		// round robin from the thread after RunPt
+		t = &Tcbs[(start+i)%(OS_MAXTHREADS+1)];
+		if(ready(t) && ((best == 0) || (t->Priority < best->Priority))){
+			best = t;
+		}
+	}
+	if(!yield && ready(RunPt) && (RunPt->Priority == best->Priority)){
+		best = RunPt;												// no switch among equals unless asked
+	}
+	if(best != RunPt){
+		NextPt = best;
+		NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+	} else{
+		NextPt = RunPt;											// a switch asked for earlier is void,
+		NVIC_INT_CTRL_R = NVIC_INT_CTRL_UNPEND_SV;	// even one already entered
+	}
+}
+
+// Set the Timer3A match to the earliest wake time, no
+// interrupt at all while no thread sleeps.  Interrupts off.
+static void arm(void){
+	unsigned long i, next, now;
+	int any;
+	any = 0;
+	next = 0;
+	now = TIMER3_TAR_R;
+	for(i=0; i<OS_MAXTHREADS; i++){
+		if(Tcbs[i].Alive && Tcbs[i].Sleeping &&
+		   (!any || ((long)(Tcbs[i].WakeTime - now) < (long)(next - now)))){
+			next = Tcbs[i].WakeTime;
+			any = 1;
+		}
+	}
+	if(!any){
+		TIMER3_IMR_R = 0;
+		return;
+	}
+	TIMER3_TAMATCHR_R = next;
+	TIMER3_ICR_R = TIMER_ICR_TAMCINT;
+	TIMER3_IMR_R = TIMER_IMR_TAMIM;
+	if((long)(TIMER3_TAR_R - next) >= 0){	// passed while setting it up
+		NVIC_PEND1_R = 1<<(35-32);
+	}
+}
+
+// Timer3A match, wake every thread that is due
+void Timer3A_Handler(void){
+	unsigned long i, now;
+	TIMER3_ICR_R = TIMER_ICR_TAMCINT;		// acknowledge match
+	now = TIMER3_TAR_R;
+	for(i=0; i<OS_MAXTHREADS; i++){
+		if(Tcbs[i].Sleeping && ((long)(now - Tcbs[i].WakeTime) >= 0)){
+			Tcbs[i].Sleeping = 0;
+		}
+	}
+	arm();
+	schedule(0);
+}
+
+// Keep the sleeping threads' remaining time across a clock change
+static void rescale(unsigned long hz, unsigned long oldhz){
+	unsigned long i, now, remain;
+	now = TIMER3_TAR_R;
+	for(i=0; i<OS_MAXTHREADS; i++){
+		if(Tcbs[i].Sleeping){
+			remain = Tcbs[i].WakeTime - now;
+			if((long)remain < 0){
+				remain = 0;
+			}
+			Tcbs[i].WakeTime = now + (unsigned long)(((unsigned long long)remain*hz)/oldhz);
+		}
+	}
+	arm();
+}
+
+// Where a thread goes when its function returns
+static void threadexit(void){
+	DisableInterrupts();
+	RunPt->Alive = 0;
+	schedule(0);
+	EnableInterrupts();
+	while(1){};														// PendSV switches away for good
+}
+
+// Runs when nothing else is ready, tickless
+static void idle(void){
+	while(1){
+		WaitForInterrupt();
+	}
+}
+
+// Stack of a thread that has not run yet: the hardware frame
+// that PendSV returns through, under R4-R11 and EXC_RETURN
+static void stackinit(struct Tcb *t, unsigned long long *stack, void(*task)(void)){
+	unsigned long *sp, i;
+	sp = (unsigned long *)&stack[OS_STACKSIZE/2];
+	*(--sp) = 0x01000000;								// xPSR, Thumb bit
+	*(--sp) = (unsigned long)task&~1;		// PC, without the Thumb bit
+	*(--sp) = (unsigned long)&threadexit;	// LR
+	for(i=0; i<5; i++){
+		*(--sp) = 0;											// R12, R3, R2, R1, R0
+	}
+	*(--sp) = 0xFFFFFFFD;								// EXC_RETURN: thread mode, PSP, no FPU frame
+	for(i=0; i<8; i++){
+		*(--sp) = 0;											// R11 to R4
+	}
+	t->Sp = sp;
+}
+
+//------------OS_Init------------
+// Clear the thread table and start the Timer3A time base,
+// call before any other OS function, interrupts disabled
+// Input: none
+// Output: none
+void OS_Init(void){
+	volatile unsigned long delay;
+	unsigned long i;
+	for(i=0; i<=OS_MAXTHREADS; i++){
+		Tcbs[i].Alive = 0;
+		Tcbs[i].Blocked = 0;
+		Tcbs[i].Sleeping = 0;
+	}
+	NumThreads = 0;
+	Launched = 0;
+	Tcbs[OS_MAXTHREADS].Priority = OS_PRIORITIES;	// below every thread
+	Tcbs[OS_MAXTHREADS].Alive = 1;
+	stackinit(&Tcbs[OS_MAXTHREADS], Stacks[OS_MAXTHREADS], &idle);
+	RunPt = &Tcbs[OS_MAXTHREADS];
+	NVIC_DEMCR_R |= NVIC_DEMCR_TRCENA;	// DWT for OS_SwitchBenchmark()
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+	SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R3;	// activate Timer3
+	delay = SYSCTL_RCGCTIMER_R;				// for clock to be stable
+	TIMER3_CTL_R = 0;									// disable Timer3A during setup
+	TIMER3_CFG_R = TIMER_CFG_32_BIT_TIMER;
+																		// free-running up count, match interrupt
+	TIMER3_TAMR_R = TIMER_TAMR_TAMR_PERIOD|TIMER_TAMR_TACDIR|TIMER_TAMR_TAMIE;
+	TIMER3_TAILR_R = 0xFFFFFFFF;			// full 32-bit range
+	TIMER3_TAPR_R = 0;								// bus clock resolution
+	TIMER3_IMR_R = 0;									// armed only while a thread sleeps
+	TIMER3_CTL_R = TIMER_CTL_TAEN;		// enable Timer3A
+																		// priority 5, interrupt 35 is bits 31-29
+	NVIC_PRI8_R = (NVIC_PRI8_R&0x00FFFFFF)|0xA0000000;
+	NVIC_EN1_R = 1<<(35-32);
+																		// PendSV priority 7, below every interrupt
+	NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R&0xFF00FFFF)|0x00E00000;
+	Clock_AddListener(&rescale);
+}
+
+//------------OS_AddThread------------
+// Add a thread before OS_Launch(), a thread that returns is
+// removed from the scheduler
+// Input: task      thread function
+//        priority  0 (highest) to OS_PRIORITIES-1
+// Output: 1 if added, 0 if all OS_MAXTHREADS are taken
+int OS_AddThread(void(*task)(void), unsigned long priority){
+	struct Tcb *t;
+	if(NumThreads >= OS_MAXTHREADS){
+		return 0;
+	}
+	t = &Tcbs[NumThreads];
+	t->Priority = (priority < OS_PRIORITIES) ? priority : (OS_PRIORITIES-1);
+	t->Blocked = 0;
+	t->Sleeping = 0;
+	t->Alive = 1;
+	stackinit(t, Stacks[NumThreads], task);
+	NumThreads = NumThreads + 1;
+	return 1;
+}
+
+//------------OS_Launch------------
+// Start the highest priority thread, enables interrupts
+// Input: none
+// Output: none, never returns
+void OS_Launch(void){
+	struct Tcb *first;
+	unsigned long i;
+	DisableInterrupts();
+	first = &Tcbs[OS_MAXTHREADS];
+	for(i=0; i<NumThreads; i++){
+		if(Tcbs[i].Priority < first->Priority){
+			first = &Tcbs[i];
+		}
+	}
+	Launched = 1;
+	OS_Start(first);
+}
+
+//------------OS_Running------------
+// Input: none
+// Output: 1 when called from a thread after OS_Launch(), so a
+//         driver may block, 0 before the launch or in a handler
+int OS_Running(void){
+	return Launched && ((NVIC_INT_CTRL_R&NVIC_INT_CTRL_VEC_ACT_M) == 0);
+}
+
+//------------OS_InitSemaphore------------
+// Input: s      semaphore
+//        value  initial count
+// Output: none
+void OS_InitSemaphore(struct OS_Sema *s, long value){
+	s->Value = value;
+}
+
+//------------OS_Wait------------
+// Take one unit, blocking the thread until one is signaled
+// Input: s  semaphore
+// Output: none
+void OS_Wait(struct OS_Sema *s){
+	long sr;
+	sr = StartCritical();
+	if(s->Value > 0){
+		s->Value = s->Value - 1;
+	} else{
+		RunPt->Blocked = s;								// OS_Signal() hands the unit over
+		schedule(0);
+	}
+	EndCritical(sr);										// the switch happens here
+}
+
+//------------OS_Signal------------
+// Give one unit, straight to the highest priority thread
+// waiting on s if there is one.  Callable from handlers.
+// Input: s  semaphore
+// Output: none
+void OS_Signal(struct OS_Sema *s){
+	struct Tcb *best;
+	unsigned long i;
+	long sr;
+	sr = StartCritical();
+	best = 0;
+	for(i=0; i<OS_MAXTHREADS; i++){
+		if((Tcbs[i].Blocked == s) && ((best == 0) || (Tcbs[i].Priority < best->Priority))){
+			best = &Tcbs[i];
+		}
+	}
+	if(best){
+		best->Blocked = 0;
+		schedule(0);
+	} else{
+		s->Value = s->Value + 1;
+	}
+	EndCritical(sr);
+}
+
+//------------OS_Suspend------------
+// Let the next ready thread of the same priority run
+// Input: none
+// Output: none
+void OS_Suspend(void){
+	long sr;
+	sr = StartCritical();
+	schedule(1);
+	EndCritical(sr);
+}
+
+//------------OS_Sleep------------
+// Block the thread for a time, other threads or the idle
+// sleep run meanwhile
+// Input: period  time in 12.5 ns units (80 MHz cycles), any
+//                bus clock, up to 2^31 bus cycles
+// Output: none
+void OS_Sleep(unsigned long period){
+	OS_SleepUntil(TIMER3_TAR_R + Clock_Scale(period));
+}
+
+//------------OS_SleepUntil------------
+// Block the thread until OS_Time() reaches a time, a periodic
+// thread adds its period to the last wake time so it does not
+// drift by the time it runs
+// Input: time  OS_Time() to wake at, less than 2^31 bus cycles ahead
+// Output: none
+void OS_SleepUntil(unsigned long time){
+	long sr;
+	sr = StartCritical();
+	if((long)(time - TIMER3_TAR_R) > 0){
+		RunPt->WakeTime = time;
+		RunPt->Sleeping = 1;
+		arm();
+		schedule(0);
+	}
+	EndCritical(sr);
+}
+
+//------------OS_Time------------
+// Input: none
+// Output: Timer3A count, bus cycles, wraps every 2^32
+unsigned long OS_Time(void){
+	return TIMER3_TAR_R;
+}
+
+//------------OS_MailboxInit------------
+// Input: mb  mailbox, starts empty
+// Output: none
+void OS_MailboxInit(struct OS_Mailbox *mb){
+	OS_InitSemaphore(&mb->Full, 0);
+	OS_InitSemaphore(&mb->Empty, 1);
+}
+
+//------------OS_MailboxSend------------
+// Put one word in the mailbox, blocking while it is full
+// Input: mb    mailbox
+//        data  message
+// Output: none
+void OS_MailboxSend(struct OS_Mailbox *mb, unsigned long data){
+	OS_Wait(&mb->Empty);
+	mb->Data = data;
+	OS_Signal(&mb->Full);
+}
+
+//------------OS_MailboxPost------------
+// Put one word in the mailbox without blocking, for handlers
+// Input: mb    mailbox
+//        data  message
+// Output: 1 if sent, 0 if the mailbox was full and data was lost
+int OS_MailboxPost(struct OS_Mailbox *mb, unsigned long data){
+	long sr;
+	sr = StartCritical();
+	if(mb->Empty.Value == 0){
+		EndCritical(sr);
+		return 0;
+	}
+	mb->Empty.Value = 0;
+	mb->Data = data;
+	OS_Signal(&mb->Full);
+	EndCritical(sr);
+	return 1;
+}
+
+//------------OS_MailboxRecv------------
+// Take the word in the mailbox, blocking while it is empty
+// Input: mb  mailbox
+// Output: message
+unsigned long OS_MailboxRecv(struct OS_Mailbox *mb){
+	unsigned long data;
+	OS_Wait(&mb->Full);
+	data = mb->Data;
+	OS_Signal(&mb->Empty);
+	return data;
+}
+
+//------------OS_SwitchBenchmark------------
+// Time 256 PendSV switches from the calling thread back to
+// itself, the full save, select and restore path.  Call from
+// a thread.  The result is in OS_SwitchCycles.
+// Input: none
+// Output: none
+void OS_SwitchBenchmark(void){
+	unsigned long i, start;
+	NextPt = RunPt;
+	start = DWT_CYCCNT_R;
+	for(i=0; i<256; i++){
+		NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;	// taken right after the store
+	}
+	OS_SwitchCycles = (DWT_CYCCNT_R - start)/256;
+}
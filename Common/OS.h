@@ -0,0 +1,149 @@
+// OS.h
+// Runs on LM4F120/TM4C123
+// Small preemptive kernel: fixed-priority threads, counting
+// semaphores and one-word mailboxes.  The context switch runs
+// in PendSV (OSasm.s) at the lowest exception priority, so an
+// interrupt handler that signals a higher priority thread
+// switches to it as soon as the handler returns.
+// Enes Kur
+// October 18, 2026
+
+// Threads run on the process stack (PSP), handlers keep the
+// main stack.  Priority 0 is the highest.  A thread runs until
+// it blocks, sleeps, calls OS_Suspend() or is preempted by a
+// higher priority thread; threads of the same priority do not
+// time-slice, OS_Suspend() passes the CPU to the next of them.
+// Idle is tickless: there is no periodic tick, Timer3A counts
+// bus cycles freely and interrupts only at the earliest wake
+// time of a sleeping thread.  With nothing ready the idle
+// thread sleeps in WFI.
+// The switch saves R4-R11 and EXC_RETURN only.  The projects
+// build with the FPU not used and startup.s leaves CP10/CP11
+// off, so threads must not use the FPU: floating point stays
+// in the compiler's software library.  Measure the switch with
+// OS_SwitchBenchmark(), 80 cycles is 1 us at 80 MHz.
+// Blocking calls (OS_Wait, OS_Sleep, OS_SleepUntil, OS_MailboxSend,
+// OS_MailboxRecv) are for threads only.  Handlers may call
+// OS_Signal() and OS_MailboxPost().
+
+#define OS_MAXTHREADS 4			// not counting the idle thread
+#define OS_STACKSIZE 256		// 32-bit words per thread, even
+#define OS_PRIORITIES 7			// 0 to 6, idle runs below 6
+
+struct OS_Sema{
+	volatile long Value;			// units available, never below 0
+};
+
+struct OS_Mailbox{
+	unsigned long Data;
+	struct OS_Sema Full;			// 1 while Data holds a message
+	struct OS_Sema Empty;			// 1 while Data may be written
+};
+
+extern unsigned long OS_SwitchCycles;	// average context switch, bus cycles
+
+//------------OS_Init------------
+// Clear the thread table and start the Timer3A time base,
+// call before any other OS function, interrupts disabled
+// Input: none
+// Output: none
+void OS_Init(void);
+
+//------------OS_AddThread------------
+// Add a thread before OS_Launch(), a thread that returns is
+// removed from the scheduler
+// Input: task      thread function
+//        priority  0 (highest) to OS_PRIORITIES-1
+// Output: 1 if added, 0 if all OS_MAXTHREADS are taken
+int OS_AddThread(void(*task)(void), unsigned long priority);
+
+//------------OS_Launch------------
+// Start the highest priority thread, enables interrupts
+// Input: none
+// Output: none, never returns
+void OS_Launch(void);
+
+//------------OS_Running------------
+// Input: none
+// Output: 1 when called from a thread after OS_Launch(), so a
+//         driver may block, 0 before the launch or in a handler
+int OS_Running(void);
+
+//------------OS_InitSemaphore------------
+// Input: s      semaphore
+//        value  initial count
+// Output: none
+void OS_InitSemaphore(struct OS_Sema *s, long value);
+
+//------------OS_Wait------------
+// Take one unit, blocking the thread until one is signaled
+// Input: s  semaphore
+// Output: none
+void OS_Wait(struct OS_Sema *s);
+
+//------------OS_Signal------------
+// Give one unit, straight to the highest priority thread
+// waiting on s if there is one.  Callable from handlers.
+// Input: s  semaphore
+// Output: none
+void OS_Signal(struct OS_Sema *s);
+
+//------------OS_Suspend------------
+// Let the next ready thread of the same priority run
+// Input: none
+// Output: none
+void OS_Suspend(void);
+
+//------------OS_Sleep------------
+// Block the thread for a time, other threads or the idle
+// sleep run meanwhile
+// Input: period  time in 12.5 ns units (80 MHz cycles), any
+//                bus clock, up to 2^31 bus cycles
+// Output: none
+void OS_Sleep(unsigned long period);
+
+//------------OS_SleepUntil------------
+// Block the thread until OS_Time() reaches a time, a periodic
+// thread adds its period to the last wake time so it does not
+// drift by the time it runs
+// Input: time  OS_Time() to wake at, less than 2^31 bus cycles ahead
+// Output: none
+void OS_SleepUntil(unsigned long time);
+
+//------------OS_Time------------
+// Input: none
+// Output: Timer3A count, bus cycles, wraps every 2^32
+unsigned long OS_Time(void);
+
+//------------OS_MailboxInit------------
+// Input: mb  mailbox, starts empty
+// Output: none
+void OS_MailboxInit(struct OS_Mailbox *mb);
+
+//------------OS_MailboxSend------------
+// Put one word in the mailbox, blocking while it is full
+// Input: mb    mailbox
+//        data  message
+// Output: none
+void OS_MailboxSend(struct OS_Mailbox *mb, unsigned long data);
+
+//------------OS_MailboxPost------------
+// Put one word in the mailbox without blocking, for handlers
+// Input: mb    mailbox
+//        data  message
+// Output: 1 if sent, 0 if the mailbox was full and data was lost
+int OS_MailboxPost(struct OS_Mailbox *mb, unsigned long data);
+
+//------------OS_MailboxRecv------------
+// Take the word in the mailbox, blocking while it is empty
+// Input: mb  mailbox
+// Output: message
+unsigned long OS_MailboxRecv(struct OS_Mailbox *mb);
+
+//------------OS_SwitchBenchmark------------
+// Time 256 PendSV switches from the calling thread back to
+// itself, the full save, select and restore path.  Call from
+// a thread.  The result is in OS_SwitchCycles.
+// Input: none
+// Output: none
+void OS_SwitchBenchmark(void);
@@ -0,0 +1,66 @@
+;*****************************************************************************
+; OSasm.s
+; Runs on LM4F120/TM4C123
+; Context switch and launch for the kernel in OS.c.
+; Each TCB starts with the saved process stack pointer.  A saved
+; thread has, from that pointer up: R4-R11, EXC_RETURN and the
+; frame the hardware pushed.  No VFP registers are saved, the
+; projects build with the FPU not used (see OS.h).
+; Enes Kur
+; October 18, 2026
+;*****************************************************************************
+
+        AREA    |.text|, CODE, READONLY, ALIGN=2
+        THUMB
+        REQUIRE8
+        PRESERVE8
+
+        IMPORT  RunPt               ; thread running now
+        IMPORT  NextPt              ; thread to run after the switch
+        EXPORT  PendSV_Handler
+        EXPORT  OS_Start
+
+;*********** PendSV_Handler ************************
+; switch from RunPt to NextPt, about 25 cycles plus the
+; 12 cycle exception entry and exit
+; inputs:  none
+; outputs: none
+PendSV_Handler
+        CPSID   I                   ; RunPt and NextPt stay put
+        MRS     R0, PSP             ; the hardware saved R0-R3, R12, LR, PC, xPSR
+        STMDB   R0!, {R4-R11, LR}   ; LR is EXC_RETURN
+        LDR     R1, =RunPt
+        LDR     R2, [R1]
+        STR     R0, [R2]            ; RunPt->Sp = PSP
+        LDR     R2, =NextPt
+        LDR     R2, [R2]
+        STR     R2, [R1]            ; RunPt = NextPt
+        LDR     R0, [R2]            ; PSP = NextPt->Sp
+        LDMIA   R0!, {R4-R11, LR}
+        MSR     PSP, R0
+        CPSIE   I
+        BX      LR                  ; the hardware restores the rest
+
+;*********** OS_Start ************************
+; run the first thread on the process stack, called with
+; interrupts disabled, never returns
+; inputs:  R0  TCB of the first thread, made by OS_AddThread()
+; outputs: none
+OS_Start
+        LDR     R1, =RunPt
+        STR     R0, [R1]
+        LDR     R0, [R0]            ; its initial stack
+        ADD     R0, R0, #36         ; skip R4-R11 and EXC_RETURN
+        LDR     LR, [R0, #20]       ; where the thread returns to
+        LDR     R1, [R0, #24]       ; the thread function
+        ORR     R1, R1, #1          ; BX needs the Thumb bit
+        ADD     R0, R0, #32         ; skip the hardware frame
+        MSR     PSP, R0
+        MOVS    R0, #2
+        MSR     CONTROL, R0         ; thread mode uses PSP
+        ISB
+        CPSIE   I
+        BX      R1
+
+        ALIGN
+        END
@@ -0,0 +1,210 @@
+// SoftTimer.c
+// Runs on LM4F120/TM4C123
+// Any number of one-shot and periodic software timers on one
+// hardware tick, Timer2A at 1 kHz, kept in a hierarchical
+// timing wheel.  Starting, stopping and expiring a timer take
+// the same time however many timers are running.
+// Enes Kur
+// October 18, 2026
+
+#include "SoftTimer.h"
+#include "Clock.h"
+#include "..//tm4c123gh6pm.h"
+
+#define SLOTS (1<<SOFTTIMER_BITS)
+#define SLOTMASK (SLOTS-1)
+#define RANGE (1UL<<(SOFTTIMER_BITS*SOFTTIMER_LEVELS))	// ticks the wheel covers
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+
+static struct SoftTimer *Wheel[SOFTTIMER_LEVELS][SLOTS];
+static volatile unsigned long Now;		// tick being run, all slots are relative to it
+static int Started;
+
+// Keep 1 ms per tick across a clock change
+static void retick(unsigned long hz, unsigned long oldhz){
+	TIMER2_TAILR_R = hz/SOFTTIMER_TICK_HZ - 1;
+}
+
+// Take a timer off its slot list.  Interrupts off.
+static void unlink(struct SoftTimer *t){
+	if(t->Prev){
+		t->Prev->Next = t->Next;
+	} else{
+		*t->Slot = t->Next;
+	}
+	if(t->Next){
+		t->Next->Prev = t->Prev;
+	}
+	t->Slot = 0;
+}
+
+// Put a timer in the slot of the lowest level that reaches
+// its expiry, at most SOFTTIMER_LEVELS-1 compares.  Interrupts off.
+static void link(struct SoftTimer *t){
+	unsigned long delta, expires, level;
+	struct SoftTimer **slot;
+	delta = t->Expires - Now;
+	expires = t->Expires;
+	if(delta >= RANGE){
+		expires = Now + RANGE - 1;					// park at the far end, placed again later
+		delta = RANGE - 1;
+	}
+	level = 0;
+	while(delta >= (1UL<<(SOFTTIMER_BITS*(level+1)))){
+		level = level + 1;
+	}
+	slot = &Wheel[level][(expires>>(SOFTTIMER_BITS*level))&SLOTMASK];
+	t->Slot = slot;
+	t->Prev = 0;
+	t->Next = *slot;
+	if(*slot){
+		(*slot)->Prev = t;
+	}
+	*slot = t;
+}
+
+// Spread one slot of a level over the levels below, one timer
+// per critical section so higher priority handlers that start
+// or stop timers wait at most one move
+static void cascade(unsigned long level){
+	struct SoftTimer *t;
+	unsigned long i;
+	long sr;
+	i = (Now>>(SOFTTIMER_BITS*level))&SLOTMASK;
+	sr = StartCritical();
+	while((t = Wheel[level][i]) != 0){
+		unlink(t);
+		link(t);
+		EndCritical(sr);
+		sr = StartCritical();
+	}
+	EndCritical(sr);
+}
+
+//------------SoftTimer_Init------------
+// Start the 1 kHz Timer2A tick with an empty wheel.  Calling
+// it again has no effect.
+// Input: none
+// Output: none
+void SoftTimer_Init(void){
+	volatile unsigned long delay;
+	unsigned long level, i;
+	if(Started){
+		return;
+	}
+	Started = 1;
+	for(level=0; level<SOFTTIMER_LEVELS; level++){
+		for(i=0; i<SLOTS; i++){
+			Wheel[level][i] = 0;
+		}
+	}
+	Now = 0;
+	SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;	// activate Timer2
+	delay = SYSCTL_RCGCTIMER_R;				// for clock to be stable
+	TIMER2_CTL_R = 0;									// disable Timer2A during setup
+	TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;
+	TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+	TIMER2_TAILR_R = Clock_Hz()/SOFTTIMER_TICK_HZ - 1;
+	TIMER2_TAPR_R = 0;
+	TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+	TIMER2_IMR_R = TIMER_IMR_TATOIM;		// timeout interrupt
+																		// priority 6, below the audio and ADC handlers
+	NVIC_PRI5_R = (NVIC_PRI5_R&0x00FFFFFF)|0xC0000000;
+	NVIC_EN0_R = 1<<23;								// IRQ 23, Timer2A
+	TIMER2_CTL_R = TIMER_CTL_TAEN;		// enable Timer2A
+	Clock_AddListener(&retick);
+}
+
+// 1 ms tick, moves the wheel on and runs the timers due now.
+// Higher priority handlers may start and stop timers, so every
+// list change here is a short critical section and the tasks
+// run with interrupts enabled.
+void Timer2A_Handler(void){
+	struct SoftTimer *t;
+	struct SoftTimer **slot;
+	void (*task)(void);
+	unsigned long level;
+	long sr;
+	TIMER2_ICR_R = TIMER_ICR_TATOCINT;	// acknowledge timeout
+	sr = StartCritical();
+	Now = Now + 1;										// a start from now on is relative to the new tick
+	EndCritical(sr);
+	level = 1;
+	while((level < SOFTTIMER_LEVELS) && ((Now&((1UL<<(SOFTTIMER_BITS*level))-1)) == 0)){
+		cascade(level);										// lower level wrapped, bring the next slot down
+		level = level + 1;
+	}
+	slot = &Wheel[0][Now&SLOTMASK];
+	sr = StartCritical();
+	while((t = *slot) != 0){						// a task may start or stop any timer
+		unlink(t);
+		if(t->Expires != Now){						// parked beyond the range
+			link(t);
+			EndCritical(sr);
+			sr = StartCritical();
+			continue;
+		}
+		if(t->Period){
+			t->Expires = Now + t->Period;		// before the task, which may stop it
+			link(t);
+		}
+		task = t->Task;
+		EndCritical(sr);
+		(*task)();
+		sr = StartCritical();
+	}
+	EndCritical(sr);
+}
+
+//------------SoftTimer_Start------------
+// Run a task after a delay, and then every period ticks.
+// Restarts a timer that is running.  Callable from handlers
+// and from timer tasks.
+// Input: t       timer, owned by the caller until stopped
+//        delay   ticks to the first run, 0 is taken as 1
+//        period  ticks between runs, 0 for one run only
+//        task    called from Timer2A_Handler
+// Output: none
+void SoftTimer_Start(struct SoftTimer *t, unsigned long delay,
+                     unsigned long period, void(*task)(void)){
+	long sr;
+	sr = StartCritical();
+	if(t->Slot){
+		unlink(t);
+	}
+	t->Expires = Now + ((delay != 0) ? delay : 1);
+	t->Period = period;
+	t->Task = task;
+	link(t);
+	EndCritical(sr);
+}
+
+//------------SoftTimer_Stop------------
+// Stop a timer, its task does not run again.  Stopping a
+// stopped timer has no effect.
+// Input: t  timer
+// Output: none
+void SoftTimer_Stop(struct SoftTimer *t){
+	long sr;
+	sr = StartCritical();
+	if(t->Slot){
+		unlink(t);
+	}
+	EndCritical(sr);
+}
+
+//------------SoftTimer_Running------------
+// Input: t  timer
+// Output: 1 while the timer is started and has a run to come
+int SoftTimer_Running(const struct SoftTimer *t){
+	return t->Slot != 0;
+}
+
+//------------SoftTimer_Ticks------------
+// Input: none
+// Output: ticks since SoftTimer_Init(), wraps after 49 days
+unsigned long SoftTimer_Ticks(void){
+	return Now;
+}
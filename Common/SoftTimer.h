@@ -0,0 +1,74 @@
+// SoftTimer.h
+// Runs on LM4F120/TM4C123
+// Any number of one-shot and periodic software timers on one
+// hardware tick, Timer2A at 1 kHz, kept in a hierarchical
+// timing wheel.  Starting, stopping and expiring a timer take
+// the same time however many timers are running.
+// Enes Kur
+// October 18, 2026
+
+// The wheel has SOFTTIMER_LEVELS levels of 64 slots, level 0
+// counts ticks, each next level counts 64 times longer.  A timer
+// goes into the slot of the level that covers its remaining
+// time, a doubly linked list per slot, so start and stop are a
+// link and an unlink.  Each tick runs the level 0 slot of that
+// tick; every 64 ticks the next level 1 slot is spread down into
+// level 0, every 4096 ticks a level 2 slot into level 1, and so
+// on.  A timer moves down at most SOFTTIMER_LEVELS-1 times in
+// its life, so expiry is constant time per timer.
+// Delays longer than the wheel (2^24 ticks, 4.6 hours) wait in
+// the last level and are placed again when they come down.
+// Tasks run in Timer2A_Handler at priority 6, they must be
+// short; post an event (Common/AO.h) or signal a semaphore for
+// longer work.  Start and stop are safe from any handler of
+// any priority: the tick handler changes the lists one timer
+// at a time with interrupts off.
+
+#define SOFTTIMER_TICK_HZ 1000	// Timer2A interrupt rate, 1 ms per tick
+#define SOFTTIMER_BITS 6				// 64 slots per level
+#define SOFTTIMER_LEVELS 4			// range 2^(6*4) ticks
+
+struct SoftTimer{
+	struct SoftTimer *Next;		// in the slot list
+	struct SoftTimer *Prev;		// 0 at the head of the list
+	struct SoftTimer **Slot;	// list the timer is on, 0 while stopped
+	unsigned long Expires;		// tick it runs at
+	unsigned long Period;			// ticks, 0 for one-shot
+	void (*Task)(void);
+};
+
+//------------SoftTimer_Init------------
+// Start the 1 kHz Timer2A tick with an empty wheel.  Calling
+// it again has no effect.
+// Input: none
+// Output: none
+void SoftTimer_Init(void);
+
+//------------SoftTimer_Start------------
+// Run a task after a delay, and then every period ticks.
+// Restarts a timer that is running.  Callable from handlers
+// and from timer tasks.
+// Input: t       timer, owned by the caller until stopped
+//        delay   ticks to the first run, 0 is taken as 1
+//        period  ticks between runs, 0 for one run only
+//        task    called from Timer2A_Handler
+// Output: none
+void SoftTimer_Start(struct SoftTimer *t, unsigned long delay,
+                     unsigned long period, void(*task)(void));
+
+//------------SoftTimer_Stop------------
+// Stop a timer, its task does not run again.  Stopping a
+// stopped timer has no effect.
+// Input: t  timer
+// Output: none
+void SoftTimer_Stop(struct SoftTimer *t);
+
+//------------SoftTimer_Running------------
+// Input: t  timer
+// Output: 1 while the timer is started and has a run to come
+int SoftTimer_Running(const struct SoftTimer *t);
+
+//------------SoftTimer_Ticks------------
+// Input: none
+// Output: ticks since SoftTimer_Init(), wraps after 49 days
+unsigned long SoftTimer_Ticks(void);
@@ -2,7 +2,12 @@
 // Runs on LM4F120/TM4C123
 // Provide functions that initialize ADC0 SS3 to be triggered by
 // software and trigger a conversion, wait for it to finish,
-// and return the result. 
+// and return the result.  SS3 can also be triggered by Timer0A,
+// then each result is delivered by the ADC0Seq3 interrupt.
+// SS0 scans up to eight channels, including the internal
+// temperature sensor, per trigger and delivers one struct per scan.
+// SS2 and the digital comparators can watch channel 1 in
+// hardware and interrupt only when the reading leaves a window.
 // Daniel Valvano
 // January 15, 2016
 
@@ -24,6 +29,20 @@
 
 #include "ADC.h"
 #include "..//tm4c123gh6pm.h"
+#include "..//Common/Clock.h"
+#include "..//Common/OS.h"
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+
+void (*ADC0Task)(unsigned long data);	// user function called with each sample
+void (*ADC0ScanTask)(const struct ADCScan *scan);	// user function called with each scan
+static struct ADCScan Scan;					// filled by ADC0Seq0_Handler
+void (*ADC0WakeTask)(void);					// user function called when the watched reading moves
+static unsigned long Paused;				// sequencers stopped by ADC0_Watch()
+static volatile int Watching;				// 1 while SS2 and the comparators are watching
+static unsigned long TriggerPeriod;	// Timer0A interval in 12.5 ns units
+static struct OS_Sema In3Done;			// signaled by ADC0Seq3_Handler for ADC0_In()
 
 // This initialization function sets up the ADC 
 // Max sample rate: <=125,000 samples/second
@@ -51,13 +70,360 @@ void ADC0_Init(void){ unsigned long delay;
 
 
 //------------ADC0_In------------
-// Busy-wait Analog to digital conversion
+// Busy-wait Analog to digital conversion.  Called from a
+// thread of the kernel in Common/OS.h it blocks instead, the
+// SS3 interrupt wakes it, 64x averaging takes 512 us.
 // Input: none
 // Output: 12-bit result of ADC conversion
 unsigned long ADC0_In(void){unsigned long data;
+	if(OS_Running()){
+		ADC0_ISC_R = 0x08;
+		ADC0_IM_R |= 0x08;						// arm SS3 interrupt
+																	// priority 2, interrupt 17 is bits 15-13
+		NVIC_PRI4_R = (NVIC_PRI4_R&0xFFFF00FF)|0x00004000;
+		NVIC_EN0_R = 1<<17;
+		ADC0_PSSI_R = 0x0008;
+		OS_Wait(&In3Done);						// other threads run meanwhile
+		return ADC0_SSFIFO3_R & 0xFFF;
+	}
 	ADC0_PSSI_R = 0x0008;
 	while((ADC0_RIS_R & 0x08) == 0){}
 	data = ADC0_SSFIFO3_R & 0xFFF;
 	ADC0_ISC_R |= 0x08;
   return data; // replace this line with proper code
 }
+
+
+// Keep the trigger interval in time across a clock change
+static void retrigger(unsigned long hz, unsigned long oldhz){
+	TIMER0_TAILR_R = Clock_Scale(TriggerPeriod)-1;
+}
+
+// Start Timer0A as a periodic ADC trigger, 32-bit, no interrupt.
+// SS0 and SS3 share it, the last period set applies to both.
+static void Timer0A_TriggerInit(unsigned long period){
+	volatile unsigned long delay;
+	SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;	// activate Timer0
+	delay = SYSCTL_RCGCTIMER_R;
+	TIMER0_CTL_R = 0;								// disable Timer0A during setup
+	TIMER0_CTL_R |= TIMER_CTL_TAOTE;// enable Timer0A trigger to ADC
+	TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+	TIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+	TIMER0_TAPR_R = 0;							// bus clock resolution
+	TriggerPeriod = period;
+	TIMER0_TAILR_R = Clock_Scale(period)-1;	// reload value
+	TIMER0_IMR_R = 0;								// ADC trigger only, no timer interrupt
+	TIMER0_CTL_R |= TIMER_CTL_TAEN;	// enable Timer0A
+	Clock_AddListener(&retrigger);
+}
+
+//------------ADC0_InitTimer0ATriggerSeq3------------
+// This initialization function sets up the ADC the same way
+// as ADC0_Init(), except that SS3 is started by Timer0A in
+// hardware.  No CPU time is spent waiting on the conversion
+// and the sample instants do not jitter with ISR latency.
+// Max sample rate: <=125,000 samples/second
+// Timer0A: 32-bit periodic, ADC trigger output, no interrupt
+// SS3 triggering event: Timer0A timeout
+// SS3 1st sample source: channel 1
+// SS3 interrupts: enabled and promoted to controller, priority 2
+// Input: period  sample interval in 12.5 ns units, any bus clock
+//        task    user function called from ADC0Seq3_Handler
+//                with each 12-bit result
+// Output: none
+void ADC0_InitTimer0ATriggerSeq3(unsigned long period, void(*task)(unsigned long data)){
+	ADC0_Init();										// port E, ADC clock and SS3 on Ain1
+	ADC0Task = task;
+	ADC0_ACTSS_R &= ~0x08;					// disable SS3 during setup
+																	// SS3 triggered by timer
+	ADC0_EMUX_R = (ADC0_EMUX_R&~ADC_EMUX_EM3_M)+ADC_EMUX_EM3_TIMER;
+	ADC0_ISC_R = 0x08;							// clear a stale SS3 flag
+	ADC0_IM_R |= 0x08;							// arm SS3 interrupt
+	ADC0_ACTSS_R |= 0x08;						// enable SS3
+																	// priority 2, interrupt 17 is bits 15-13
+	NVIC_PRI4_R = (NVIC_PRI4_R&0xFFFF00FF)|0x00004000;
+	NVIC_EN0_R = 1<<17;							// enable interrupt 17 in NVIC
+	Timer0A_TriggerInit(period);
+}
+
+//------------ADC0Seq3_Handler------------
+// Executes when SS3 finishes a timer-triggered conversion
+// and passes the 12-bit result to the user task, or when
+// SS3 finishes a conversion a thread waits for in ADC0_In()
+void ADC0Seq3_Handler(void){
+	ADC0_ISC_R = 0x08;							// acknowledge SS3 completion
+	if(ADC0Task){
+		(*ADC0Task)(ADC0_SSFIFO3_R&0xFFF);
+	} else{
+		ADC0_IM_R &= ~0x08;						// until the next ADC0_In()
+		OS_Signal(&In3Done);					// the result stays in the FIFO
+	}
+}
+
+//------------ADC0_SetAveraging------------
+// Configure the ADC0 hardware averager.  Every sample
+// delivered by a sequencer is then the average of 2^log2n
+// back-to-back conversions, so one sample takes 2^log2n
+// conversion times (8 us each at 125,000 samples/second).
+// Input: log2n  0 (off) to 6 (64x), larger values are limited to 6
+// Output: none
+void ADC0_SetAveraging(unsigned long log2n){
+	if(log2n > 6){
+		log2n = 6;
+	}
+	ADC0_SAC_R = (ADC0_SAC_R&~ADC_SAC_AVG_M)+log2n;
+}
+
+//------------ADC0_SetTriggerPeriod------------
+// Change the Timer0A trigger interval while sampling, used
+// to slow down the sample rate when the signal is still.
+// Applies to both SS0 and SS3, they share the timer.
+// Input: period  sample interval in 12.5 ns units, any bus clock
+// Output: none
+void ADC0_SetTriggerPeriod(unsigned long period){
+	TriggerPeriod = period;
+	TIMER0_TAILR_R = Clock_Scale(period)-1;	// TAILD clear, takes effect on the next count
+}
+
+//*************** SS0 multi-channel scan *****************
+// Analog input pins, AINn is on port AinPort[n] bit AinBit[n]
+static const char AinPort[12] = {'E','E','E','E','D','D','D','D','E','E','B','B'};
+static const unsigned char AinBit[12] = {3, 2, 1, 0, 3, 2, 1, 0, 5, 4, 4, 5};
+
+// Make the pin of an analog channel an analog input
+static void ainpin(unsigned long ch){
+	volatile unsigned long delay;
+	unsigned long m;
+	m = 1<<AinBit[ch];
+	if(AinPort[ch] == 'B'){
+		SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOB;
+		delay = SYSCTL_RCGC2_R;
+		GPIO_PORTB_DIR_R &= ~m;
+		GPIO_PORTB_DEN_R &= ~m;
+		GPIO_PORTB_AFSEL_R |= m;
+		GPIO_PORTB_AMSEL_R |= m;
+	} else if(AinPort[ch] == 'D'){
+		SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOD;
+		delay = SYSCTL_RCGC2_R;
+		GPIO_PORTD_DIR_R &= ~m;
+		GPIO_PORTD_DEN_R &= ~m;
+		GPIO_PORTD_AFSEL_R |= m;
+		GPIO_PORTD_AMSEL_R |= m;
+	} else{
+		SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOE;
+		delay = SYSCTL_RCGC2_R;
+		GPIO_PORTE_DIR_R &= ~m;
+		GPIO_PORTE_DEN_R &= ~m;
+		GPIO_PORTE_AFSEL_R |= m;
+		GPIO_PORTE_AMSEL_R |= m;
+	}
+}
+
+//------------ADC0_InitScanSeq0------------
+// This initialization function sets up SS0 to convert a list
+// of channels, one after the other, on every trigger.  The
+// whole scan costs one trigger and one interrupt however many
+// channels it has.  Hardware averaging applies to every step.
+// Max sample rate: <=125,000 samples/second, shared by the steps
+// SS0 triggering event: Timer0A timeout, or software with period 0
+// SS0 sample sources: channels[0] to channels[n-1]
+// SS0 interrupts: enabled and promoted to controller, priority 2
+//                 (timer trigger only)
+// Input: channels  list of 0 to 11 (AIN0 to AIN11) or ADCSCAN_TEMP
+//        n         1 to 8 channels
+//        period    scan interval in 12.5 ns units, any bus clock,
+//                  0 for software start with ADC0_InScan()
+//        task      user function called from ADC0Seq0_Handler with
+//                  each scan, not used with period 0
+// Output: none
+void ADC0_InitScanSeq0(const unsigned char *channels, unsigned long n,
+                       unsigned long period, void(*task)(const struct ADCScan *scan)){
+	volatile unsigned long delay;
+	unsigned long i, mux, ctl;
+	if(n > ADCSCAN_MAXCH){
+		n = ADCSCAN_MAXCH;
+	}
+	mux = 0;
+	ctl = 0;
+	for(i=0; i<n; i++){
+		if(channels[i] == ADCSCAN_TEMP){
+			ctl |= ADC_SSCTL0_TS0<<(4*i);	// step i reads the temperature sensor
+		} else{
+			ainpin(channels[i]);
+			mux |= (channels[i]&0x0F)<<(4*i);
+		}
+	}
+	ctl |= (ADC_SSCTL0_END0|ADC_SSCTL0_IE0)<<(4*(n-1));	// last step ends the scan
+	Scan.Count = n;
+	ADC0ScanTask = task;
+	SYSCTL_RCGC0_R |= 0x00010000;		// activate ADC0
+	delay = SYSCTL_RCGC2_R;
+	SYSCTL_RCGC0_R = (SYSCTL_RCGC0_R & 0xFFFFFCFF);	// 125K max rate
+	ADC0_SSPRI_R = 0x3210;					// SS0 highest, ahead of the SS2 watch on Timer0A
+	ADC0_ACTSS_R &= ~0x01;					// disable SS0 during setup
+	ADC0_SSMUX0_R = mux;
+	ADC0_SSCTL0_R = ctl;
+	ADC0_ISC_R = 0x01;							// clear a stale SS0 flag
+	if(period){											// SS0 triggered by timer
+		ADC0_EMUX_R = (ADC0_EMUX_R&~ADC_EMUX_EM0_M)+ADC_EMUX_EM0_TIMER;
+		ADC0_IM_R |= 0x01;						// arm SS0 interrupt
+																	// priority 2, interrupt 14 is bits 23-21
+		NVIC_PRI3_R = (NVIC_PRI3_R&0xFF00FFFF)|0x00400000;
+		NVIC_EN0_R = 1<<14;						// enable interrupt 14 in NVIC
+	} else{													// SS0 triggered by software
+		ADC0_EMUX_R = (ADC0_EMUX_R&~ADC_EMUX_EM0_M);
+		ADC0_IM_R &= ~0x01;
+	}
+	ADC0_ACTSS_R |= 0x01;						// enable SS0
+	if(period){
+		Timer0A_TriggerInit(period);
+	}
+}
+
+// Move one finished scan from the SS0 FIFO into a struct
+static void readscan(struct ADCScan *scan){
+	unsigned long i;
+	for(i=0; i<scan->Count; i++){
+		scan->Data[i] = ADC0_SSFIFO0_R&0xFFF;
+	}
+}
+
+//------------ADC0_InScan------------
+// Busy-wait scan of all channels, software triggered SS0
+// Input: scan  where to store the results
+// Output: none
+// assumes: ADC0_InitScanSeq0() with period 0
+void ADC0_InScan(struct ADCScan *scan){
+	ADC0_PSSI_R = 0x0001;						// start SS0
+	while((ADC0_RIS_R & 0x01) == 0){}
+	scan->Count = Scan.Count;
+	readscan(scan);
+	ADC0_ISC_R = 0x01;
+}
+
+//------------ADC0Seq0_Handler------------
+// Executes when SS0 finishes a timer-triggered scan and
+// passes all results to the user task at once.  The struct
+// is reused for the next scan, copy what must be kept.
+void ADC0Seq0_Handler(void){
+	ADC0_ISC_R = 0x01;							// acknowledge SS0 completion
+	readscan(&Scan);
+	(*ADC0ScanTask)(&Scan);
+}
+
+//------------ADC0_TempC------------
+// Convert an internal temperature sensor sample
+// TEMP = 147.5 - 75*3.3*sample/4096 deg C
+// Input: sample  12-bit result of an ADCSCAN_TEMP step
+// Output: temperature in 0.1 deg C, signed
+long ADC0_TempC(unsigned long sample){
+	return 1475 - (long)((2475*sample + 2048)>>12);
+}
+
+//*************** Digital comparator watch *****************
+// SS2 converts channel 1 twice per trigger and sends both
+// results to the digital comparators instead of a FIFO.  DC0
+// interrupts when the reading falls below the window, DC1 when
+// it rises above it.  While a window is armed the sampling
+// sequencers are off, so no interrupt at all happens until
+// the pot is moved.
+
+//------------ADC0_InitWatch------------
+// Set up SS2 and digital comparators 0 and 1 for ADC0_Watch().
+// Call after the Timer0A triggered sequencer has been set up,
+// SS2 uses the same trigger and hardware averaging.
+// SS2 triggering event: Timer0A timeout
+// SS2 sample sources: channel 1, steps 0 and 1
+// SS2 interrupts: digital comparators only, priority 2
+// Input: task  user function called from ADC0Seq2_Handler when
+//              the reading leaves the window
+// Output: none
+void ADC0_InitWatch(void(*task)(void)){
+	ADC0WakeTask = task;
+	Watching = 0;
+	ADC0_ACTSS_R &= ~0x04;					// SS2 off until a window is armed
+	ADC0_EMUX_R = (ADC0_EMUX_R&~ADC_EMUX_EM2_M)+ADC_EMUX_EM2_TIMER;
+	ADC0_SSMUX2_R = 0x0011;					// steps 0 and 1 both Ain1
+	ADC0_SSCTL2_R = ADC_SSCTL2_END1;// two steps, no sample interrupt
+	ADC0_SSOP2_R = ADC_SSOP2_S0DCOP+ADC_SSOP2_S1DCOP;	// results to comparators only
+	ADC0_SSDC2_R = 0x0010;					// step 0 to DC0, step 1 to DC1
+	ADC0_IM_R = (ADC0_IM_R&~0x04)|ADC_IM_DCONSS2;	// comparators on the SS2 vector
+																	// priority 2, interrupt 16 is bits 7-5
+	NVIC_PRI4_R = (NVIC_PRI4_R&0xFFFFFF00)|0x00000040;
+	NVIC_EN0_R = 1<<16;							// enable interrupt 16 in NVIC
+}
+
+//------------ADC0_Watch------------
+// Stop sampling and let the hardware watch channel 1 until
+// the reading leaves low to high.  The sampling sequencers
+// restart on their own when it does, before the task runs.
+// A window end at 0 or 4095 is not watched, the reading
+// cannot go past it.
+// Input: low   lowest 12-bit reading inside the window
+//        high  highest 12-bit reading inside the window
+// Output: none
+// assumes: ADC0_InitWatch()
+void ADC0_Watch(unsigned long low, unsigned long high){
+	if(Watching){
+		return;
+	}
+	if(high > 4094){
+		high = 4094;
+		ADC0_DCCTL1_R = ADC_DCCTL1_CIC_HIGH+ADC_DCCTL1_CIM_ONCE;
+	} else{													// high band is high+1 and up
+		ADC0_DCCTL1_R = ADC_DCCTL1_CIE+ADC_DCCTL1_CIC_HIGH+ADC_DCCTL1_CIM_ONCE;
+	}
+	if(low == 0){
+		ADC0_DCCTL0_R = ADC_DCCTL0_CIC_LOW+ADC_DCCTL0_CIM_ONCE;
+	} else{													// low band is below low
+		ADC0_DCCTL0_R = ADC_DCCTL0_CIE+ADC_DCCTL0_CIC_LOW+ADC_DCCTL0_CIM_ONCE;
+	}
+	ADC0_DCCMP0_R = ((high+1)<<ADC_DCCMP0_COMP1_S)+low;
+	ADC0_DCCMP1_R = ((high+1)<<ADC_DCCMP1_COMP1_S)+low;
+	ADC0_DCRIC_R = 0x03;						// forget the old comparison state
+	ADC0_DCISC_R = 0x03;						// clear stale comparator flags
+	Paused = ADC0_ACTSS_R&0x09;			// SS0 and SS3 sample the pot
+	ADC0_ACTSS_R = (ADC0_ACTSS_R&~0x09)|0x04;
+	Watching = 1;
+}
+
+//------------ADC0_WatchStop------------
+// Disarm the window and restart the sequencers ADC0_Watch()
+// stopped.  Does nothing if no window is armed.
+// Input: none
+// Output: none
+void ADC0_WatchStop(void){
+	long sr;
+	sr = StartCritical();						// main and ADC0Seq2_Handler both stop it
+	if(!Watching){
+		EndCritical(sr);
+		return;
+	}
+	Watching = 0;
+	ADC0_ACTSS_R &= ~0x04;
+	while((ADC0_SSFSTAT0_R&ADC_SSFSTAT0_EMPTY) == 0){
+		ADC0_SSFIFO0_R;								// drop a scan cut short by ADC0_Watch()
+	}
+	while((ADC0_SSFSTAT3_R&ADC_SSFSTAT3_EMPTY) == 0){
+		ADC0_SSFIFO3_R;
+	}
+	ADC0_ISC_R = 0x09;
+	ADC0_ACTSS_R |= Paused;
+	EndCritical(sr);
+}
+
+//------------ADC0_Watching------------
+// Input: none
+// Output: 1 while a window is armed, 0 while sampling
+int ADC0_Watching(void){
+	return Watching;
+}
+
+//------------ADC0Seq2_Handler------------
+// Executes when a digital comparator sees the reading leave
+// the window, restarts sampling and calls the user task
+void ADC0Seq2_Handler(void){
+	ADC0_DCISC_R = 0x03;						// acknowledge DC0 and DC1
+	ADC0_WatchStop();
+	(*ADC0WakeTask)();
+}
@@ -2,7 +2,12 @@
 // Runs on LM4F120/TM4C123
 // Provide functions that initialize ADC0 SS3 to be triggered by
 // software and trigger a conversion, wait for it to finish,
-// and return the result. 
+// and return the result.  SS3 can also be triggered by Timer0A,
+// then each result is delivered by the ADC0Seq3 interrupt.
+// SS0 scans up to eight channels, including the internal
+// temperature sensor, per trigger and delivers one struct per scan.
+// SS2 and the digital comparators can watch channel 1 in
+// hardware and interrupt only when the reading leaves a window.
 // Daniel Valvano
 // January 15, 2016
 
@@ -22,6 +27,14 @@
  http://users.ece.utexas.edu/~valvano/
  */
 
+#define ADCSCAN_MAXCH 8		// SS0 has 8 steps and an 8-entry FIFO
+#define ADCSCAN_TEMP 0xFF	// channel code of the internal temperature sensor
+
+// One SS0 scan, samples in the order of the channel list
+struct ADCScan{
+	unsigned long Count;					// number of channels in the scan
+	unsigned short Data[ADCSCAN_MAXCH];	// 12-bit samples
+};
 
 // This initialization function sets up the ADC 
 // Max sample rate: <=125,000 samples/second
@@ -33,7 +46,115 @@ void ADC0_Init(void);
 
 
 //------------ADC0_In------------
-// Busy-wait Analog to digital conversion
+// Busy-wait Analog to digital conversion.  Called from a
+// thread of the kernel in Common/OS.h it blocks instead, the
+// SS3 interrupt wakes it.  Not for use with
+// ADC0_InitTimer0ATriggerSeq3().
 // Input: none
 // Output: 12-bit result of ADC conversion
 unsigned long ADC0_In(void);
+
+
+
+//------------ADC0_InitTimer0ATriggerSeq3------------
+// This initialization function sets up the ADC the same way
+// as ADC0_Init(), except that SS3 is started by Timer0A in
+// hardware and finished samples are delivered by interrupt.
+// Max sample rate: <=125,000 samples/second
+// Timer0A: 32-bit periodic, ADC trigger output, no interrupt
+// SS3 triggering event: Timer0A timeout
+// SS3 1st sample source: channel 1
+// SS3 interrupts: enabled and promoted to controller, priority 2
+// Input: period  sample interval in 12.5 ns units, any bus clock
+//        task    user function called from ADC0Seq3_Handler
+//                with each 12-bit result
+// Output: none
+void ADC0_InitTimer0ATriggerSeq3(unsigned long period, void(*task)(unsigned long data));
+
+//------------ADC0_SetAveraging------------
+// Configure the ADC0 hardware averager.  Every sample
+// delivered by a sequencer is then the average of 2^log2n
+// back-to-back conversions, so one sample takes 2^log2n
+// conversion times (8 us each at 125,000 samples/second).
+// Input: log2n  0 (off) to 6 (64x), larger values are limited to 6
+// Output: none
+void ADC0_SetAveraging(unsigned long log2n);
+
+//------------ADC0_SetTriggerPeriod------------
+// Change the Timer0A trigger interval while sampling, used
+// to slow down the sample rate when the signal is still.
+// Applies to both SS0 and SS3, they share the timer.
+// Input: period  sample interval in 12.5 ns units, any bus clock
+// Output: none
+void ADC0_SetTriggerPeriod(unsigned long period);
+
+//------------ADC0_InitScanSeq0------------
+// This initialization function sets up SS0 to convert a list
+// of channels, one after the other, on every trigger.  The
+// whole scan costs one trigger and one interrupt however many
+// channels it has.  Hardware averaging applies to every step.
+// With a timer trigger SS0 shares Timer0A with SS3.
+// Max sample rate: <=125,000 samples/second, shared by the steps
+// SS0 triggering event: Timer0A timeout, or software with period 0
+// SS0 sample sources: channels[0] to channels[n-1]
+// SS0 interrupts: enabled and promoted to controller, priority 2
+//                 (timer trigger only)
+// Input: channels  list of 0 to 11 (AIN0 to AIN11) or ADCSCAN_TEMP
+//        n         1 to 8 channels
+//        period    scan interval in 12.5 ns units, any bus clock,
+//                  0 for software start with ADC0_InScan()
+//        task      user function called from ADC0Seq0_Handler with
+//                  each scan, not used with period 0
+// Output: none
+void ADC0_InitScanSeq0(const unsigned char *channels, unsigned long n,
+                       unsigned long period, void(*task)(const struct ADCScan *scan));
+
+//------------ADC0_InScan------------
+// Busy-wait scan of all channels, software triggered SS0
+// Input: scan  where to store the results
+// Output: none
+// assumes: ADC0_InitScanSeq0() with period 0
+void ADC0_InScan(struct ADCScan *scan);
+
+//------------ADC0_TempC------------
+// Convert an internal temperature sensor sample
+// TEMP = 147.5 - 75*3.3*sample/4096 deg C
+// Input: sample  12-bit result of an ADCSCAN_TEMP step
+// Output: temperature in 0.1 deg C, signed
+long ADC0_TempC(unsigned long sample);
+
+//------------ADC0_InitWatch------------
+// Set up SS2 and digital comparators 0 and 1 for ADC0_Watch().
+// Call after the Timer0A triggered sequencer has been set up,
+// SS2 uses the same trigger and hardware averaging.
+// SS2 triggering event: Timer0A timeout
+// SS2 sample sources: channel 1, steps 0 and 1
+// SS2 interrupts: digital comparators only, priority 2
+// Input: task  user function called from ADC0Seq2_Handler when
+//              the reading leaves the window
+// Output: none
+void ADC0_InitWatch(void(*task)(void));
+
+//------------ADC0_Watch------------
+// Stop sampling and let the hardware watch channel 1 until
+// the reading leaves low to high.  The sampling sequencers
+// restart on their own when it does, before the task runs.
+// A window end at 0 or 4095 is not watched, the reading
+// cannot go past it.
+// Input: low   lowest 12-bit reading inside the window
+//        high  highest 12-bit reading inside the window
+// Output: none
+// assumes: ADC0_InitWatch()
+void ADC0_Watch(unsigned long low, unsigned long high);
+
+//------------ADC0_WatchStop------------
+// Disarm the window and restart the sequencers ADC0_Watch()
+// stopped.  Does nothing if no window is armed.
+// Input: none
+// Output: none
+void ADC0_WatchStop(void);
+
+//------------ADC0_Watching------------
+// Input: none
+// Output: 1 while a window is armed, 0 while sampling
+int ADC0_Watching(void);
@@ -0,0 +1,263 @@
+// Calibrate.c
+// Runs on LM4F120/TM4C123
+// Calibration of the angle pot.  A guided capture with the
+// LaunchPad switches records the ADC reading at known angles:
+// two points give a gain and offset for Convert_Fix(), more
+// points also build a piecewise-linear correction table for
+// pots that are not linear.  The result is kept in EEPROM.
+// Enes Kur
+// October 18, 2026
+
+// SW1 connected to PF4, SW2 connected to PF0 (negative logic)
+// Presses are latched by the port F interrupt, so a short one
+// is not lost between two polls and a press wakes the CPU.
+
+#include "Calibrate.h"
+#include "Convert.h"
+#include "EEPROM.h"
+#include "Format.h"
+#include "..//tm4c123gh6pm.h"
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+
+#define CAL_SHIFT (16-CAL_SEGBITS)		// 12.4 samples span 2^16
+#define CAL_MAGIC 0x43414C31					// "CAL1"
+#define CAL_ADDR 0										// first EEPROM word
+#define CAL_WORDS (sizeof(struct CalData)/4)
+#define SW1 0x10											// PF4
+#define SW2 0x01											// PF0
+
+// Calibration record, saved to EEPROM as it is
+struct CalData{
+	unsigned long Magic;			// CAL_MAGIC when valid
+	unsigned long Gain;				// two-point gain, 0.20 (see Convert.h)
+	long Offset;							// two-point offset, 0.1 deg
+	unsigned long UseLut;			// 1: Lut[] replaces the two-point line
+	long Lut[CAL_POINTS];			// angle in 0.1 deg at sample i<<CAL_SHIFT
+	unsigned long Sum;				// sum of the words above
+};
+static struct CalData Cal[2];			// the ISR reads Cal[Active], a new one is built in the other
+static volatile unsigned long Active;
+
+// capture state
+enum CalState{ IDLE, CAPTURE, SAVED, FAILED };
+static enum CalState State;
+static unsigned long Step;					// reference being captured
+static unsigned long Samples[CAL_MAXREFS];
+static unsigned long LastSwitches;
+static volatile unsigned long Latched;	// falling edges since the last poll
+
+// sum of all words of a record except Sum
+static unsigned long checksum(const struct CalData *c){
+	const unsigned long *p;
+	unsigned long i, sum;
+	p = (const unsigned long *)c;
+	sum = 0;
+	for(i=0; i<(CAL_WORDS-1); i++){
+		sum = sum + p[i];
+	}
+	return sum;
+}
+
+// Reference angle of capture step k, 0.1 deg
+static long refangle(unsigned long k){
+	return (long)(k*CAL_FULLSCALE/(CAL_REFS-1));
+}
+
+// Make Cal[next] the one used by the ISR and Convert_Fix()
+static void apply(unsigned long next){
+	long sr;
+	sr = StartCritical();								// gain and offset change together
+	Convert_Init(Cal[next].Gain, Cal[next].Offset);
+	Active = next;
+	EndCritical(sr);
+}
+
+// Build a calibration from the captured samples into c
+// Output: 1 for success, 0 if the samples do not increase
+static int compute(struct CalData *c){
+	unsigned long i, k, n;
+	long s0, s1, a0, a1, g;
+	n = CAL_REFS;
+	for(k=1; k<n; k++){
+		if(Samples[k] <= Samples[k-1]){
+			return 0;												// pot not turned the right way
+		}
+	}
+																			// two-point line through the end points
+	s0 = Samples[0]; s1 = Samples[n-1];
+	a0 = refangle(0); a1 = refangle(n-1);
+	c->Gain = (unsigned long)((((unsigned long long)(a1-a0))<<24)/(unsigned long)(s1-s0));
+	c->Offset = a0 - (long)(((unsigned long long)s0*c->Gain + 0x800000)>>24);
+	c->UseLut = (n > 2);
+																			// resample the captured points onto the table grid
+	k = 0;
+	for(i=0; i<CAL_POINTS; i++){
+		g = (long)(i<<CAL_SHIFT);
+		while((k < (n-2)) && (g >= (long)Samples[k+1])){
+			k++;														// segment k holds g, the outer ones extrapolate
+		}
+		s0 = Samples[k]; s1 = Samples[k+1];
+		a0 = refangle(k); a1 = refangle(k+1);
+		c->Lut[i] = a0 + (long)(((long long)(g-s0)*(a1-a0)*2 + (s1-s0))/(2*(s1-s0)));
+	}
+	c->Magic = CAL_MAGIC;
+	c->Sum = checksum(c);
+	return 1;
+}
+
+// Set up PF4 and PF0 as inputs with pull-ups, PF0 has to be unlocked
+static void switchinit(void){ volatile unsigned long delay;
+	SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOF;	// activate port F
+	delay = SYSCTL_RCGC2_R;
+	GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;		// unlock PF0
+	GPIO_PORTF_CR_R |= (SW1|SW2);
+	GPIO_PORTF_DIR_R &= ~(SW1|SW2);				// make PF4,0 in
+	GPIO_PORTF_AFSEL_R &= ~(SW1|SW2);
+	GPIO_PORTF_PCTL_R &= ~0x000F000F;
+	GPIO_PORTF_AMSEL_R &= ~(SW1|SW2);
+	GPIO_PORTF_PUR_R |= (SW1|SW2);				// switches pull to ground
+	GPIO_PORTF_DEN_R |= (SW1|SW2);
+	GPIO_PORTF_IS_R &= ~(SW1|SW2);				// edge sensitive
+	GPIO_PORTF_IBE_R &= ~(SW1|SW2);				// not both edges
+	GPIO_PORTF_IEV_R &= ~(SW1|SW2);				// falling edge, press
+	GPIO_PORTF_ICR_R = (SW1|SW2);
+	GPIO_PORTF_IM_R |= (SW1|SW2);
+																				// priority 5, interrupt 30 is bits 23-21
+	NVIC_PRI7_R = (NVIC_PRI7_R&0xFF00FFFF)|0x00A00000;
+	NVIC_EN0_R = 1<<30;										// enable interrupt 30 in NVIC
+}
+
+// Latch switch presses until Calibrate_Poll() takes them
+void GPIOPortF_Handler(void){
+	unsigned long edges;
+	edges = GPIO_PORTF_RIS_R&(SW1|SW2);
+	GPIO_PORTF_ICR_R = edges;
+	Latched |= edges;
+}
+
+//------------Calibrate_Init------------
+// Set up the switches and the EEPROM and load the saved
+// calibration, or use the nominal 0.73 deg/10 per LSB if there
+// is none.  Call before the ADC interrupts are enabled.
+// Input: none
+// Output: 1 if a saved calibration was loaded, 0 for the defaults
+int Calibrate_Init(void){
+	switchinit();
+	LastSwitches = SW1|SW2;
+	Latched = 0;
+	State = IDLE;
+	if(EEPROM_Init()){
+		EEPROM_Read(CAL_ADDR, (unsigned long *)&Cal[0], CAL_WORDS);
+		if((Cal[0].Magic == CAL_MAGIC) && (Cal[0].Sum == checksum(&Cal[0]))){
+			apply(0);
+			return 1;
+		}
+	}
+	Cal[0].Gain = CONVERT_DEFAULT_GAIN;		// 0.73*4095 = 300 deg pot
+	Cal[0].Offset = CONVERT_DEFAULT_OFFSET;
+	Cal[0].UseLut = 0;
+	apply(0);
+	return 0;
+}
+
+//------------Calibrate_Angle------------
+// Convert a 12.4 fixed-point ADC sample to an angle with the
+// current calibration, called from the sample ISR.  About 20
+// cycles with the table, Convert_Fix() without it.
+// Input: sample  12.4 fixed-point ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Calibrate_Angle(unsigned long sample){
+	const struct CalData *c;
+	unsigned long i;
+	long f, angle;
+	c = &Cal[Active];
+	if(!c->UseLut){
+		return Convert_Fix(sample);
+	}
+	i = (sample>>CAL_SHIFT)&((1<<CAL_SEGBITS)-1);	// segment, a shift instead of a search
+	f = sample&((1<<CAL_SHIFT)-1);								// position in the segment
+	angle = c->Lut[i] + (((c->Lut[i+1]-c->Lut[i])*f + (1<<(CAL_SHIFT-1)))>>CAL_SHIFT);
+	if(angle < 0){
+		return 0;
+	}
+	return angle;
+}
+
+//------------Calibrate_Poll------------
+// Run the guided capture, call from the foreground with every
+// new decimated sample (8 to 60 times a second, which also
+// debounces the switches).  Presses are latched by interrupt
+// in between.
+// Input: sample  latest 12.4 fixed-point ADC sample
+// Output: 1 if the prompt changed and should be redrawn
+int Calibrate_Poll(unsigned long sample){
+	unsigned long sw, pressed, next, edges;
+	long sr;
+	sr = StartCritical();
+	edges = Latched;
+	Latched = 0;
+	EndCritical(sr);
+	sw = GPIO_PORTF_DATA_R&(SW1|SW2);
+																				// down now or pressed since the last poll,
+																				// and up at the last poll, bounce on release
+																				// is not a new press
+	pressed = LastSwitches&(~sw|edges);
+	LastSwitches = sw;
+	if(pressed&SW2){
+		if(State == CAPTURE){
+			State = IDLE;										// abort, keep the old calibration
+		} else{
+			State = CAPTURE;
+			Step = 0;
+		}
+		return 1;
+	}
+	if((State != CAPTURE) || ((pressed&SW1) == 0)){
+		return 0;
+	}
+	Samples[Step] = sample;
+	Step = Step + 1;
+	if(Step < CAL_REFS){
+		return 1;													// ask for the next angle
+	}
+	next = Active^1;
+	if(!compute(&Cal[next])){
+		State = FAILED;
+		return 1;
+	}
+	apply(next);
+	State = EEPROM_Write(CAL_ADDR, (const unsigned long *)&Cal[next], CAL_WORDS) ? SAVED : FAILED;
+	return 1;
+}
+
+//------------Calibrate_Prompt------------
+// Text for the top row right of the digits, over the units,
+// all spaces when there is nothing to say; CAL_PROMPTLEN
+// characters padded with spaces
+// Input: buf  at least CAL_PROMPTLEN+1 bytes
+// Output: none
+void Calibrate_Prompt(char *buf){
+	unsigned long i;
+	const char *msg;
+	msg = "";
+	if(State == CAPTURE){
+		msg = "@";												// "@050.0", turn to the angle, press SW1
+	} else if(State == SAVED){
+		msg = "Saved";
+	} else if(State == FAILED){
+		msg = "Failed";
+	}
+	for(i=0; msg[i]; i++){
+		buf[i] = msg[i];
+	}
+	if(State == CAPTURE){
+		i = i + Format_Fix(&buf[i], refangle(Step), 3, 1);
+	}
+	while(i < CAL_PROMPTLEN){
+		buf[i] = ' ';
+		i = i + 1;
+	}
+	buf[CAL_PROMPTLEN] = 0;
+}
@@ -0,0 +1,58 @@
+// Calibrate.h
+// Runs on LM4F120/TM4C123
+// Calibration of the angle pot.  A guided capture with the
+// LaunchPad switches records the ADC reading at known angles:
+// two points give a gain and offset for Convert_Fix(), more
+// points also build a piecewise-linear correction table for
+// pots that are not linear.  The result is kept in EEPROM.
+// Enes Kur
+// October 18, 2026
+
+// Capture: press SW2 (PF0) to start.  The LCD asks for the
+// reference angles 0 to CAL_FULLSCALE in equal steps ("@050.0"
+// next to the angle), turn the pot to each one and press SW1 (PF4).  SW2 again aborts and
+// keeps the old calibration.
+// Runtime: the table has 2^CAL_SEGBITS segments of equal width
+// in ADC counts, so Calibrate_Angle() finds the segment with a
+// shift and interpolates with one multiply and a shift, there
+// is no divide per sample.  Divides only happen at capture time.
+
+#define CAL_SEGBITS 5				// 32 segments, 33 points (4 for 17 points)
+#define CAL_POINTS ((1<<CAL_SEGBITS)+1)
+#define CAL_REFS 7					// reference angles in a capture, 2 to CAL_MAXREFS
+#define CAL_MAXREFS 17
+#define CAL_FULLSCALE 3000	// 0.1 deg, last reference angle
+#define CAL_PROMPTLEN 6			// characters from Calibrate_Prompt()
+
+//------------Calibrate_Init------------
+// Set up the switches and the EEPROM and load the saved
+// calibration, or use the nominal 0.73 deg/10 per LSB if there
+// is none.  Call before the ADC interrupts are enabled.
+// Input: none
+// Output: 1 if a saved calibration was loaded, 0 for the defaults
+int Calibrate_Init(void);
+
+//------------Calibrate_Angle------------
+// Convert a 12.4 fixed-point ADC sample to an angle with the
+// current calibration, called from the sample ISR.  About 20
+// cycles with the table, Convert_Fix() without it.
+// Input: sample  12.4 fixed-point ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Calibrate_Angle(unsigned long sample);
+
+//------------Calibrate_Poll------------
+// Run the guided capture, call from the foreground with every
+// new decimated sample (8 to 60 times a second, which also
+// debounces the switches).  Presses are latched by interrupt
+// in between.
+// Input: sample  latest 12.4 fixed-point ADC sample
+// Output: 1 if the prompt changed and should be redrawn
+int Calibrate_Poll(unsigned long sample);
+
+//------------Calibrate_Prompt------------
+// Text for the top row right of the digits, over the units,
+// all spaces when there is nothing to say; CAL_PROMPTLEN
+// characters padded with spaces
+// Input: buf  at least CAL_PROMPTLEN+1 bytes
+// Output: none
+void Calibrate_Prompt(char *buf);
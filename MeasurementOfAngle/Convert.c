@@ -0,0 +1,92 @@
+// Convert.c
+// Runs on LM4F120/TM4C123
+// Converts ADC samples of the angle pot into a fixed-point
+// angle with 0.1 deg resolution using integer multiply and
+// shift only.  The FPU is not enabled in startup.s, so the
+// old double precision 0.73*sample ran through the soft-float
+// library on every sample.
+// Enes Kur
+// October 18, 2026
+
+// Expected cost at 80 MHz, -O1, no FPU
+// Convert_Float  __aeabi_ui2d + __aeabi_dmul + __aeabi_d2uiz,
+//                roughly 100-150 cycles (1.3-1.9 us)
+// Convert_Fix    one UMULL, a 64-bit add and shift and the clamp,
+//                about 10 cycles including call overhead
+// Run Convert_Benchmark() on the board for the actual numbers.
+
+#include "Convert.h"
+#include "CycleCount.h"
+
+static unsigned long Gain = CONVERT_DEFAULT_GAIN;
+static long Offset = CONVERT_DEFAULT_OFFSET;
+
+unsigned long Convert_FixCycles;
+unsigned long Convert_FloatCycles;
+unsigned long Convert_Errors;
+
+//********Convert_Init****************
+// Set the calibration used by Convert_Fix()
+// Input: gain    0.1 deg per ADC LSB, 0.20 fixed point (use CONVERT_GAIN())
+//        offset  0.1 deg, signed
+// Output: none
+void Convert_Init(unsigned long gain, long offset){
+	Gain = gain;
+	Offset = offset;
+}
+
+//********Convert_Fix****************
+// Convert a 12.4 fixed-point ADC sample into a 32-bit unsigned
+// fixed-point angle (resolution 0.1 deg), rounded to nearest.
+// About 10 cycles, no library calls.
+// Input: sample  12.4 fixed-point ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Convert_Fix(unsigned long sample){
+	long angle;
+																			// 12.4 * 0.20 = 32.24 fixed point
+	angle = (long)(((unsigned long long)sample*Gain + 0x800000)>>24) + Offset;
+	if(angle < 0){
+		return 0;
+	}
+	return angle;
+}
+
+//********Convert_Float****************
+// Original double precision conversion, 0.73*sample truncated.
+// Kept as the reference for Convert_Benchmark().
+// Input: sample  12-bit ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Convert_Float(unsigned long sample){
+  return (0.73*sample);	// 0.73*4095 = 300 degrees which is pot turn amount
+}
+
+//********Convert_Benchmark****************
+// Run both conversions over every 12-bit ADC code, measure
+// them with the DWT cycle counter and check the integer path
+// against the exact rounded value.  Uses the default gain.
+// Results can be inspected in the debugger watch window.
+// Input: none
+// Output: none
+void Convert_Benchmark(void){
+	unsigned long code, start, fix, flt, exact, overhead;
+	volatile unsigned long sink;				// keeps the calls from being optimized out
+	CycleCount_Init();
+	overhead = CycleCount_Overhead();
+	Convert_Init(CONVERT_DEFAULT_GAIN, CONVERT_DEFAULT_OFFSET);
+	fix = flt = 0;
+	Convert_Errors = 0;
+	for(code=0; code<4096; code++){
+		start = CycleCount_Get();
+		sink = Convert_Fix(code<<4);
+		fix = fix + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		sink = Convert_Float(code);
+		flt = flt + (CycleCount_Get() - start - overhead);
+		exact = (73*code + 50)/100;				// round(0.73*code), integer reference
+		if(Convert_Fix(code<<4) != exact){
+			Convert_Errors++;
+		}
+	}
+	Convert_FixCycles = fix/4096;
+	Convert_FloatCycles = flt/4096;
+}
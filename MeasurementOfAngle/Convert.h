@@ -0,0 +1,59 @@
+// Convert.h
+// Runs on LM4F120/TM4C123
+// Converts ADC samples of the angle pot into a fixed-point
+// angle with 0.1 deg resolution using integer multiply and
+// shift only.  The FPU is not enabled in startup.s, so the
+// old double precision 0.73*sample ran through the soft-float
+// library on every sample.
+// Enes Kur
+// October 18, 2026
+
+// angle = ((sample*Gain + 2^23) >> 24) + Offset
+// sample  12.4 fixed point ADC code (0 to 65535)
+// Gain    0.1 deg per ADC LSB in 0.20 fixed point
+// Offset  0.1 deg, added after scaling, result is clamped at 0
+// The 64-bit product is a single UMULL on the Cortex-M4.
+// The gain is rounded up to the next 2^-20, for the default
+// 0.73 that is 765461, 0.5e-6 too large, which adds at most
+// 0.002 display LSB at code 4095.  Since 0.73*code is always a
+// multiple of 0.01, every code rounds exactly like round(0.73*code).
+
+																// deg/10 per LSB to 0.20, rounded up
+#define CONVERT_GAIN(x) ((unsigned long)((x)*1048576.0+0.999999))
+#define CONVERT_DEFAULT_GAIN CONVERT_GAIN(0.73)	// 0.73*4095 = 300 deg pot
+#define CONVERT_DEFAULT_OFFSET 0
+
+//********Convert_Init****************
+// Set the calibration used by Convert_Fix()
+// Input: gain    0.1 deg per ADC LSB, 0.20 fixed point (use CONVERT_GAIN())
+//        offset  0.1 deg, signed
+// Output: none
+void Convert_Init(unsigned long gain, long offset);
+
+//********Convert_Fix****************
+// Convert a 12.4 fixed-point ADC sample into a 32-bit unsigned
+// fixed-point angle (resolution 0.1 deg), rounded to nearest.
+// About 10 cycles, no library calls.
+// Input: sample  12.4 fixed-point ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Convert_Fix(unsigned long sample);
+
+//********Convert_Float****************
+// Original double precision conversion, 0.73*sample truncated.
+// Kept as the reference for Convert_Benchmark().
+// Input: sample  12-bit ADC sample
+// Output: 32-bit angle (resolution 0.1 deg)
+unsigned long Convert_Float(unsigned long sample);
+
+//********Convert_Benchmark****************
+// Run both conversions over every 12-bit ADC code, measure
+// them with the DWT cycle counter and check the integer path
+// against the exact rounded value.  Uses the default gain.
+// Results can be inspected in the debugger watch window.
+// Input: none
+// Output: none
+void Convert_Benchmark(void);
+
+extern unsigned long Convert_FixCycles;		// average cycles per Convert_Fix()
+extern unsigned long Convert_FloatCycles;	// average cycles per Convert_Float()
+extern unsigned long Convert_Errors;			// codes where Convert_Fix() differs from round(0.73*code)
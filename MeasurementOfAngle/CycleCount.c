@@ -0,0 +1,44 @@
+// CycleCount.c
+// Runs on LM4F120/TM4C123
+// Bus cycle counter for benchmarking, uses the free-running
+// DWT cycle counter of the Cortex-M4 (12.5 ns per count at 80 MHz).
+// Enes Kur
+// October 18, 2026
+
+#include "CycleCount.h"
+
+#define NVIC_DEMCR_R            (*((volatile unsigned long *)0xE000EDFC))
+#define NVIC_DEMCR_TRCENA       0x01000000  // Trace system enable
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Cycle counter enable
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+
+//------------CycleCount_Init------------
+// Enable the trace unit and start the DWT cycle counter
+// Input: none
+// Output: none
+void CycleCount_Init(void){
+	NVIC_DEMCR_R |= NVIC_DEMCR_TRCENA;	// DWT is off until trace is enabled
+	DWT_CYCCNT_R = 0;
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+}
+
+//------------CycleCount_Get------------
+// Read the cycle counter, wraps every 2^32 cycles
+// Take the difference of two reads to time a piece of code,
+// subtract CycleCount_Overhead() for the cost of the reads.
+// Input: none
+// Output: 32-bit cycle count
+unsigned long CycleCount_Get(void){
+	return DWT_CYCCNT_R;
+}
+
+//------------CycleCount_Overhead------------
+// Cycles measured around empty code, two back-to-back reads
+// Input: none
+// Output: cycles to subtract from a measurement
+unsigned long CycleCount_Overhead(void){
+	unsigned long start;
+	start = CycleCount_Get();
+	return CycleCount_Get() - start;
+}
@@ -0,0 +1,26 @@
+// CycleCount.h
+// Runs on LM4F120/TM4C123
+// Bus cycle counter for benchmarking, uses the free-running
+// DWT cycle counter of the Cortex-M4 (12.5 ns per count at 80 MHz).
+// Enes Kur
+// October 18, 2026
+
+//------------CycleCount_Init------------
+// Enable the trace unit and start the DWT cycle counter
+// Input: none
+// Output: none
+void CycleCount_Init(void);
+
+//------------CycleCount_Get------------
+// Read the cycle counter, wraps every 2^32 cycles
+// Take the difference of two reads to time a piece of code,
+// subtract CycleCount_Overhead() for the cost of the reads.
+// Input: none
+// Output: 32-bit cycle count
+unsigned long CycleCount_Get(void);
+
+//------------CycleCount_Overhead------------
+// Cycles measured around empty code, two back-to-back reads
+// Input: none
+// Output: cycles to subtract from a measurement
+unsigned long CycleCount_Overhead(void);
@@ -0,0 +1,75 @@
+// EEPROM.c
+// Runs on LM4F120/TM4C123
+// Driver for the 2 kB on-chip EEPROM, 512 32-bit words in 32
+// blocks of 16.  Addresses are word numbers, 0 to 511.
+// Enes Kur
+// October 18, 2026
+
+#include "EEPROM.h"
+#include "..//tm4c123gh6pm.h"
+
+																		// left set in EEDONE when a write failed
+#define EEDONE_ERRORS (EEPROM_EEDONE_INVPL|EEPROM_EEDONE_WRBUSY|EEPROM_EEDONE_NOPERM)
+
+// wait until the EEPROM is not busy
+static void waitdone(void){
+	while(EEPROM_EEDONE_R&EEPROM_EEDONE_WORKING){};
+}
+
+//------------EEPROM_Init------------
+// Activate the EEPROM and wait for it to finish its power-up
+// checks
+// Input: none
+// Output: 1 if the EEPROM is ready, 0 if it reports an error
+int EEPROM_Init(void){ volatile unsigned long delay;
+	SYSCTL_RCGCEEPROM_R |= SYSCTL_RCGCEEPROM_R0;	// activate EEPROM
+	while((SYSCTL_PREEPROM_R&SYSCTL_PREEPROM_R0) == 0){};
+	delay = SYSCTL_RCGCEEPROM_R;				// at least 6 cycles before EEDONE is valid
+	delay = SYSCTL_RCGCEEPROM_R;
+	waitdone();
+	if(EEPROM_EESUPP_R&(EEPROM_EESUPP_PRETRY|EEPROM_EESUPP_ERETRY)){
+		return 0;													// power-up recovery failed
+	}
+	return 1;
+}
+
+//------------EEPROM_Read------------
+// Read consecutive words
+// Input: addr  first word, 0 to 511
+//        buf   where to store the words
+//        n     number of words, addr+n at most 512
+// Output: none
+void EEPROM_Read(unsigned long addr, unsigned long *buf, unsigned long n){
+	unsigned long i;
+	for(i=0; i<n; i++){
+		if((i == 0) || ((addr&0x0F) == 0)){
+			EEPROM_EEBLOCK_R = addr>>4;			// the offset wraps inside a block
+			EEPROM_EEOFFSET_R = addr&0x0F;
+		}
+		buf[i] = EEPROM_EERDWRINC_R;
+		addr = addr + 1;
+	}
+}
+
+//------------EEPROM_Write------------
+// Write consecutive words, busy-waits until each one is stored
+// Input: addr  first word, 0 to 511
+//        buf   words to store
+//        n     number of words, addr+n at most 512
+// Output: 1 for success, 0 if a write failed
+int EEPROM_Write(unsigned long addr, const unsigned long *buf, unsigned long n){
+	unsigned long i;
+	for(i=0; i<n; i++){
+		if((i == 0) || ((addr&0x0F) == 0)){
+			EEPROM_EEBLOCK_R = addr>>4;			// the offset wraps inside a block
+			EEPROM_EEOFFSET_R = addr&0x0F;
+		}
+		EEPROM_EERDWRINC_R = buf[i];
+		waitdone();
+		if(EEPROM_EEDONE_R&EEDONE_ERRORS){
+			return 0;
+		}
+		addr = addr + 1;
+	}
+	return 1;
+}
@@ -0,0 +1,33 @@
+// EEPROM.h
+// Runs on LM4F120/TM4C123
+// Driver for the 2 kB on-chip EEPROM, 512 32-bit words in 32
+// blocks of 16.  Addresses are word numbers, 0 to 511.
+// Reads are immediate, each word written takes up to a few
+// hundred microseconds (more if the EEPROM has to compact).
+// Enes Kur
+// October 18, 2026
+
+#define EEPROM_WORDS 512
+
+//------------EEPROM_Init------------
+// Activate the EEPROM and wait for it to finish its power-up
+// checks
+// Input: none
+// Output: 1 if the EEPROM is ready, 0 if it reports an error
+int EEPROM_Init(void);
+
+//------------EEPROM_Read------------
+// Read consecutive words
+// Input: addr  first word, 0 to 511
+//        buf   where to store the words
+//        n     number of words, addr+n at most 512
+// Output: none
+void EEPROM_Read(unsigned long addr, unsigned long *buf, unsigned long n);
+
+//------------EEPROM_Write------------
+// Write consecutive words, busy-waits until each one is stored
+// Input: addr  first word, 0 to 511
+//        buf   words to store
+//        n     number of words, addr+n at most 512
+// Output: 1 for success, 0 if a write failed
+int EEPROM_Write(unsigned long addr, const unsigned long *buf, unsigned long n);
@@ -0,0 +1,61 @@
+// FIFO.c
+// Runs on LM4F120/TM4C123
+// Lock-free single-producer/single-consumer FIFO carrying
+// angle samples from the sample ISR to the foreground.
+// Replaces the single-slot Angle/Flag mailbox, which lost
+// samples whenever the LCD path was slower than the ISR.
+// Enes Kur
+// October 18, 2026
+
+#include "FIFO.h"
+
+#define FIFOMASK (FIFOSIZE-1)
+
+static unsigned long Fifo[FIFOSIZE];
+static volatile unsigned long PutI;		// written by the producer only
+static volatile unsigned long GetI;		// written by the consumer only
+unsigned long Fifo_Overflows;
+
+//------------Fifo_Init------------
+// Make the FIFO empty and clear the overflow counter
+// Input: none
+// Output: none
+void Fifo_Init(void){
+	PutI = GetI = 0;
+	Fifo_Overflows = 0;
+}
+
+//------------Fifo_Put------------
+// Add an element, called by the producer only
+// Input: data  element to store
+// Output: 1 for success, 0 if the FIFO was full (data dropped)
+int Fifo_Put(unsigned long data){
+	if((PutI - GetI) >= FIFOSIZE){
+		Fifo_Overflows++;
+		return 0;
+	}
+	Fifo[PutI & FIFOMASK] = data;
+	PutI = PutI + 1;								// publish after the slot is written
+	return 1;
+}
+
+//------------Fifo_Get------------
+// Remove the oldest element, called by the consumer only
+// Input: datapt  where to store the element
+// Output: 1 for success, 0 if the FIFO was empty
+int Fifo_Get(unsigned long *datapt){
+	if(GetI == PutI){
+		return 0;
+	}
+	*datapt = Fifo[GetI & FIFOMASK];
+	GetI = GetI + 1;								// release the slot after the read
+	return 1;
+}
+
+//------------Fifo_Size------------
+// Number of elements waiting, safe from either side
+// Input: none
+// Output: 0 to FIFOSIZE
+unsigned long Fifo_Size(void){
+	return PutI - GetI;
+}
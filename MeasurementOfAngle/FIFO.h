@@ -0,0 +1,42 @@
+// FIFO.h
+// Runs on LM4F120/TM4C123
+// Lock-free single-producer/single-consumer FIFO carrying
+// angle samples from the sample ISR to the foreground.
+// Replaces the single-slot Angle/Flag mailbox, which lost
+// samples whenever the LCD path was slower than the ISR.
+// Enes Kur
+// October 18, 2026
+
+// Only Fifo_Put() writes PutI and only Fifo_Get() writes GetI.
+// Both are free-running 32-bit counters that are read and
+// written with single instructions, so neither side ever
+// disables interrupts.  Put must be called from one context
+// (the sample ISR) and Get from one other (main).
+
+#define FIFOSIZE 64					// entries, must be a power of 2
+
+extern unsigned long Fifo_Overflows;	// samples dropped because the FIFO was full
+
+//------------Fifo_Init------------
+// Make the FIFO empty and clear the overflow counter
+// Input: none
+// Output: none
+void Fifo_Init(void);
+
+//------------Fifo_Put------------
+// Add an element, called by the producer only
+// Input: data  element to store
+// Output: 1 for success, 0 if the FIFO was full (data dropped)
+int Fifo_Put(unsigned long data);
+
+//------------Fifo_Get------------
+// Remove the oldest element, called by the consumer only
+// Input: datapt  where to store the element
+// Output: 1 for success, 0 if the FIFO was empty
+int Fifo_Get(unsigned long *datapt);
+
+//------------Fifo_Size------------
+// Number of elements waiting, safe from either side
+// Input: none
+// Output: 0 to FIFOSIZE
+unsigned long Fifo_Size(void);
@@ -0,0 +1,199 @@
+// Filter.c
+// Runs on LM4F120/TM4C123
+// Fixed-point filters for ADC samples: 3 or 5 tap median for
+// spike rejection, a first-order IIR low pass in Q15 and a
+// biquad in Q31.
+// Enes Kur
+// October 18, 2026
+
+#include "Filter.h"
+#include "CycleCount.h"
+
+// Saturate a 64-bit result to 32 bits
+static long sat32(long long x){
+	if(x > 0x7FFFFFFFLL) return 0x7FFFFFFF;
+	if(x < -0x80000000LL) return (long)(-0x7FFFFFFF-1);
+	return (long)x;
+}
+
+#if defined(__TARGET_FEATURE_DSPMUL)
+// ARM compiler on a core with the DSP extension, one cycle each
+#define QADD(a,b) __qadd((a),(b))
+#define QSUB(a,b) __qsub((a),(b))
+#else
+// Saturating 32-bit add and subtract in C
+#define QADD(a,b) sat32((long long)(a)+(b))
+#define QSUB(a,b) sat32((long long)(a)-(b))
+#endif
+
+unsigned long Filter_Median3Cycles;
+unsigned long Filter_Median5Cycles;
+unsigned long Filter_IIR1Cycles;
+unsigned long Filter_BiquadCycles;
+
+// Put a and b in order, a <= b
+#define SORT2(a,b) if((a) > (b)){ t = (a); (a) = (b); (b) = t; }
+
+// Median of three with two compares on each path
+static short median3(short a, short b, short c){
+	short t;
+	SORT2(a, b);
+	if(c <= a) return a;
+	if(c >= b) return b;
+	return c;
+}
+
+// Median of five with 7 compare-exchanges (partial sorting network)
+static short median5(const short *x){
+	short p0, p1, p2, p3, p4, t;
+	p0 = x[0]; p1 = x[1]; p2 = x[2]; p3 = x[3]; p4 = x[4];
+	SORT2(p0, p1); SORT2(p3, p4); SORT2(p0, p3);
+	SORT2(p1, p4); SORT2(p1, p2); SORT2(p2, p3);
+	SORT2(p1, p2);
+	return p2;
+}
+
+//------------Filter_MedianInit------------
+// Set up a median filter, the first outputs are medians of
+// the inputs seen so far
+// Input: f     filter state
+//        taps  3 or 5, other values give 3
+// Output: none
+void Filter_MedianInit(struct FilterMedian *f, unsigned long taps){
+	f->Taps = (taps == 5) ? 5 : 3;
+	f->I = 0;
+	f->Count = 0;
+}
+
+//------------Filter_Median------------
+// Median of the last 3 or 5 inputs, removes single (3 taps)
+// or double (5 taps) sample spikes, delays by 1 or 2 samples
+// Input: f  filter state
+//        x  new sample
+// Output: median
+short Filter_Median(struct FilterMedian *f, short x){
+	unsigned long i;
+	if(f->Count == 0){
+		for(i=0; i<f->Taps; i++){	// start from a flat history
+			f->X[i] = x;
+		}
+		f->Count = 1;
+	}
+	f->X[f->I] = x;
+	f->I = f->I + 1;
+	if(f->I == f->Taps){
+		f->I = 0;
+	}
+	if(f->Taps == 5){
+		return median5(f->X);
+	}
+	return median3(f->X[0], f->X[1], f->X[2]);
+}
+
+//------------Filter_IIR1Init------------
+// Set up a first-order low pass.  For a cutoff fc at sample
+// rate fs alpha is about 1-exp(-2*pi*fc/fs).
+// Input: f      filter state
+//        alpha  Q15 smoothing factor, use FILTER_Q15(0.1) for 0.1
+//        y0     starting output, usually the first sample
+// Output: none
+void Filter_IIR1Init(struct FilterIIR1 *f, short alpha, short y0){
+	f->Alpha = alpha;
+	f->Y = (long)y0<<16;
+}
+
+//------------Filter_IIR1------------
+// One step of the first-order low pass, no limit cycles since
+// the state has 16 more bits than the output
+// Input: f  filter state
+//        x  new Q15 sample
+// Output: filtered Q15 sample
+short Filter_IIR1(struct FilterIIR1 *f, short x){
+	long e;
+	e = QSUB((long)x<<16, f->Y);					// error, saturated to 32 bits
+																		// e*alpha is Q31*Q15, SMULL and a shift
+	f->Y = QADD(f->Y, (long)(((long long)e*f->Alpha)>>15));
+	return (short)(QADD(f->Y, 0x8000)>>16);	// rounded
+}
+
+//------------Filter_BiquadInit------------
+// Set up a biquad and clear its history.  Coefficients are
+// normalized to a0 = 1 and must be less than 2 in magnitude.
+// Input: f       filter state
+//        b0..a2  2.30 coefficients, use FILTER_Q30(x)
+// Output: none
+void Filter_BiquadInit(struct FilterBiquad *f, long b0, long b1, long b2, long a1, long a2){
+	f->B0 = b0;
+	f->B1 = b1;
+	f->B2 = b2;
+	f->NegA1 = -a1;
+	f->NegA2 = -a2;
+	f->X1 = f->X2 = 0;
+	f->Y1 = f->Y2 = 0;
+}
+
+//------------Filter_Biquad------------
+// One step of the biquad, 64-bit accumulator, the output is
+// rounded and saturated to Q31
+// Input: f  filter state
+//        x  new Q31 sample, a Q15 sample shifted left 16
+// Output: filtered Q31 sample
+long Filter_Biquad(struct FilterBiquad *f, long x){
+	long long acc;
+	long y;
+	acc = 1LL<<29;										// round the 2.30 products
+	acc += (long long)f->B0*x;				// five SMLALs
+	acc += (long long)f->B1*f->X1;
+	acc += (long long)f->B2*f->X2;
+	acc += (long long)f->NegA1*f->Y1;
+	acc += (long long)f->NegA2*f->Y2;
+	y = sat32(acc>>30);
+	f->X2 = f->X1;
+	f->X1 = x;
+	f->Y2 = f->Y1;
+	f->Y1 = y;
+	return y;
+}
+
+//------------Filter_Benchmark------------
+// Time each filter with the DWT cycle counter, averaged over
+// 1024 samples of a noisy ramp.  Results can be inspected in
+// the debugger watch window.
+// Input: none
+// Output: none
+void Filter_Benchmark(void){
+	struct FilterMedian m3, m5;
+	struct FilterIIR1 lp;
+	struct FilterBiquad bq;
+	unsigned long n, start, overhead, c3, c5, ci, cb;
+	short x;
+	volatile long sink;								// keeps the calls from being optimized out
+	CycleCount_Init();
+	overhead = CycleCount_Overhead();
+	Filter_MedianInit(&m3, 3);
+	Filter_MedianInit(&m5, 5);
+	Filter_IIR1Init(&lp, FILTER_Q15(0.1), 0);
+																		// 2nd order Butterworth low pass, fc = fs/16
+	Filter_BiquadInit(&bq, FILTER_Q30(0.02995), FILTER_Q30(0.05990), FILTER_Q30(0.02995),
+	                  FILTER_Q30(-1.45424), FILTER_Q30(0.57404));
+	c3 = c5 = ci = cb = 0;
+	for(n=0; n<1024; n++){
+		x = (short)(n*4 + ((n*2654435761UL)>>26));	// ramp plus pseudo-random noise
+		start = CycleCount_Get();
+		sink = Filter_Median(&m3, x);
+		c3 = c3 + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		sink = Filter_Median(&m5, x);
+		c5 = c5 + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		sink = Filter_IIR1(&lp, x);
+		ci = ci + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		sink = Filter_Biquad(&bq, (long)x<<16);
+		cb = cb + (CycleCount_Get() - start - overhead);
+	}
+	Filter_Median3Cycles = c3/1024;
+	Filter_Median5Cycles = c5/1024;
+	Filter_IIR1Cycles = ci/1024;
+	Filter_BiquadCycles = cb/1024;
+}
@@ -0,0 +1,277 @@
+// Format.c
+// Runs on LM4F120/TM4C123
+// Integer to decimal ASCII formatting shared by the LCD and
+// the angle display.  Digits are produced with a reciprocal
+// multiply divide-by-10 (one UMULL and a shift), there is no
+// division instruction and no recursion.
+// Enes Kur
+// October 18, 2026
+
+// Expected cost at 80 MHz, -O1, "xxx.x" angle string
+// old  4 digits, each two recursive Pow() calls (up to 4 levels),
+//      a UDIV and a modulus, roughly 250-350 cycles
+// new  4 digits, each one UMULL, one MLS-style subtract,
+//      roughly 60-80 cycles
+// Run Format_Benchmark() on the board for the actual numbers.
+
+#include "Format.h"
+#include "CycleCount.h"
+
+unsigned long Format_AngleOldCycles;
+unsigned long Format_AngleNewCycles;
+unsigned long Format_UDecOldCycles;
+unsigned long Format_UDecNewCycles;
+
+//-----------------------Format_Div10-----------------------
+// Divide by 10 with a reciprocal multiply, exact for all
+// 32-bit inputs: n/10 = (n*0xCCCCCCCD) >> 35
+// Input: n  32-bit unsigned number
+// Output: n/10
+unsigned long Format_Div10(unsigned long n){
+	return (unsigned long)(((unsigned long long)n*0xCCCCCCCDUL)>>35);
+}
+
+// Writes the digits of n backward, the last digit goes to
+// end[-1].  Writes at least one digit, 10 at most.
+// Returns the number of digits.
+static unsigned long Digits(char *end, unsigned long n){
+	unsigned long q, cnt;
+	cnt = 0;
+	do{
+		q = Format_Div10(n);
+		end--;
+		*end = (char)(n - q*10) + '0';	// remainder without a divide
+		n = q;
+		cnt++;
+	} while(n);
+	return cnt;
+}
+
+// Fills a field with '*', the number does not fit
+static int Stars(char *pt, unsigned long width){
+	unsigned long i;
+	for(i=0; i<width; i++){
+		pt[i] = '*';
+	}
+	pt[width] = 0;
+	return width;
+}
+
+//-----------------------Format_UDec-----------------------
+// Unsigned decimal
+// Input: pt     output buffer, at least width+1 (or 11) bytes
+//        n      32-bit unsigned number
+//        width  0 for variable size, else right justified field size
+//        fill   character in front of the number, ' ' or '0'
+// Output: characters written
+int Format_UDec(char *pt, unsigned long n, unsigned long width, char fill){
+	char buf[10];
+	unsigned long len, i, cnt;
+	len = Digits(buf+10, n);
+	cnt = 0;
+	if(width){
+		if(len > width){
+			return Stars(pt, width);
+		}
+		while(cnt < (width-len)){
+			pt[cnt] = fill;
+			cnt++;
+		}
+	}
+	for(i=10-len; i<10; i++){
+		pt[cnt] = buf[i];
+		cnt++;
+	}
+	pt[cnt] = 0;
+	return cnt;
+}
+
+//-----------------------Format_SDec-----------------------
+// Signed decimal, the '-' goes in front of the first digit
+// and counts toward the width
+// Input: pt     output buffer, at least width+1 (or 12) bytes
+//        n      32-bit signed number
+//        width  0 for variable size, else right justified field size
+//        fill   ' ' (sign next to digits) or '0' (sign in first column)
+// Output: characters written
+int Format_SDec(char *pt, long n, unsigned long width, char fill){
+	char buf[10];
+	unsigned long mag, len, neg, i, cnt;
+	neg = (n < 0);
+	mag = neg ? (0-(unsigned long)n) : (unsigned long)n;	// also right for -2^31
+	len = Digits(buf+10, mag);
+	cnt = 0;
+	if(width){
+		if((len+neg) > width){
+			return Stars(pt, width);
+		}
+		if(neg && (fill == '0')){
+			pt[cnt] = '-';
+			cnt++;
+		}
+		while(cnt < (width-len-((fill == '0') ? 0 : neg))){
+			pt[cnt] = fill;
+			cnt++;
+		}
+		if(neg && (fill != '0')){
+			pt[cnt] = '-';
+			cnt++;
+		}
+	} else if(neg){
+		pt[cnt] = '-';
+		cnt++;
+	}
+	for(i=10-len; i<10; i++){
+		pt[cnt] = buf[i];
+		cnt++;
+	}
+	pt[cnt] = 0;
+	return cnt;
+}
+
+//-----------------------Format_Fix-----------------------
+// Signed fixed point, n is in units of 10^-decimals and is
+// shown with intdigits zero-padded digits before the point.
+// A '-' is added in front of negative values.
+// Input: pt         output buffer, at least intdigits+decimals+3 bytes
+//        n          32-bit signed fixed-point number
+//        intdigits  1 to 9 digits before the point
+//        decimals   0 to 9 digits after the point
+// Output: characters written
+int Format_Fix(char *pt, long n, unsigned long intdigits, unsigned long decimals){
+	char buf[18];
+	unsigned long mag, q, total, i, cnt;
+	if(intdigits < 1) intdigits = 1;
+	if(intdigits > 9) intdigits = 9;
+	if(decimals > 9) decimals = 9;
+	total = intdigits + decimals;
+	mag = (n < 0) ? (0-(unsigned long)n) : (unsigned long)n;
+	for(i=total; i>0; i--){							// exactly total digits, zero padded
+		q = Format_Div10(mag);
+		buf[i-1] = (char)(mag - q*10) + '0';
+		mag = q;
+	}
+	cnt = 0;
+	if(n < 0){
+		pt[cnt] = '-';
+		cnt++;
+	}
+	for(i=0; i<total; i++){
+		if(i == intdigits){
+			pt[cnt] = '.';
+			cnt++;
+		}
+		pt[cnt] = mag ? '*' : buf[i];			// digits left over, too big
+		cnt++;
+	}
+	pt[cnt] = 0;
+	return cnt;
+}
+
+//----------- reference routines for Format_Benchmark -----------
+
+// takes the exponent with recursive method, from MeasurementOfAngle.c
+static unsigned long Pow(unsigned long k, unsigned long l){
+	if(k == 0) return 0;
+	if(l == 0) return 1;
+	return k*Pow(k, l-1);
+}
+
+// old UART_ConvertAngle() digit loop, "xxx.x"
+static void OldAngle(char *String, unsigned long n){
+	unsigned long cnt, cnt1, dec, check, ree;
+	cnt = 0; cnt1 = 0; dec = 0; check = 0;
+	if(n < 10000){
+		check = 1;
+	}
+	while(cnt <= 4){
+		if(check){
+			ree = n/Pow(10, 3-cnt1);
+			String[cnt] = (ree + 0x30);
+			ree = Pow(10, 3-cnt1);
+			n = n%ree;
+		}
+		else
+			String[cnt] = '*';
+		if(dec == 2){
+			cnt++;
+			String[cnt] = '.';
+		}
+		cnt++;
+		cnt1++;
+		dec++;
+	}
+	String[cnt] = 0;
+}
+
+// old Nokia5110_OutUDec() divide chain, five right-justified digits
+static void OldUDec(char *pt, unsigned short n){
+	if(n < 10){
+		pt[0] = pt[1] = pt[2] = pt[3] = ' ';
+		pt[4] = n+'0';
+	} else if(n < 100){
+		pt[0] = pt[1] = pt[2] = ' ';
+		pt[3] = n/10+'0';
+		pt[4] = n%10+'0';
+	} else if(n < 1000){
+		pt[0] = pt[1] = ' ';
+		pt[2] = n/100+'0';
+		n = n%100;
+		pt[3] = n/10+'0';
+		pt[4] = n%10+'0';
+	} else if(n < 10000){
+		pt[0] = ' ';
+		pt[1] = n/1000+'0';
+		n = n%1000;
+		pt[2] = n/100+'0';
+		n = n%100;
+		pt[3] = n/10+'0';
+		pt[4] = n%10+'0';
+	} else{
+		pt[0] = n/10000+'0';
+		n = n%10000;
+		pt[1] = n/1000+'0';
+		n = n%1000;
+		pt[2] = n/100+'0';
+		n = n%100;
+		pt[3] = n/10+'0';
+		pt[4] = n%10+'0';
+	}
+	pt[5] = 0;
+}
+
+//-----------------------Format_Benchmark-----------------------
+// Time the formatter against the routines it replaced, the
+// recursive Pow() based UART_ConvertAngle() and the divide
+// chain of Nokia5110_OutUDec(), with the DWT cycle counter.
+// Angles 0 to 3000 (0.1 deg) and every 16-bit number are used.
+// Input: none
+// Output: none
+void Format_Benchmark(void){
+	char buf[12];
+	unsigned long n, start, overhead, oldc, newc;
+	CycleCount_Init();
+	overhead = CycleCount_Overhead();
+	oldc = newc = 0;
+	for(n=0; n<=3000; n++){
+		start = CycleCount_Get();
+		OldAngle(buf, n);
+		oldc = oldc + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		Format_Fix(buf, n, 3, 1);
+		newc = newc + (CycleCount_Get() - start - overhead);
+	}
+	Format_AngleOldCycles = oldc/3001;
+	Format_AngleNewCycles = newc/3001;
+	oldc = newc = 0;
+	for(n=0; n<=0xFFFF; n++){
+		start = CycleCount_Get();
+		OldUDec(buf, n);
+		oldc = oldc + (CycleCount_Get() - start - overhead);
+		start = CycleCount_Get();
+		Format_UDec(buf, n, 5, ' ');
+		newc = newc + (CycleCount_Get() - start - overhead);
+	}
+	Format_UDecOldCycles = oldc/0x10000;
+	Format_UDecNewCycles = newc/0x10000;
+}
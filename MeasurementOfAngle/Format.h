@@ -0,0 +1,74 @@
+// Format.h
+// Runs on LM4F120/TM4C123
+// Integer to decimal ASCII formatting shared by the LCD and
+// the angle display.  Digits are produced with a reciprocal
+// multiply divide-by-10 (one UMULL and a shift), there is no
+// division instruction and no recursion.
+// Enes Kur
+// October 18, 2026
+
+// All functions write a NULL-terminated string to pt and
+// return the number of characters written, not counting the NULL.
+// Values that do not fit a fixed width are shown as '*'s
+// so the field keeps its size on the display.
+
+//-----------------------Format_Div10-----------------------
+// Divide by 10 with a reciprocal multiply, exact for all
+// 32-bit inputs: n/10 = (n*0xCCCCCCCD) >> 35
+// Input: n  32-bit unsigned number
+// Output: n/10
+unsigned long Format_Div10(unsigned long n);
+
+//-----------------------Format_UDec-----------------------
+// Unsigned decimal
+// Input: pt     output buffer, at least width+1 (or 11) bytes
+//        n      32-bit unsigned number
+//        width  0 for variable size, else right justified field size
+//        fill   character in front of the number, ' ' or '0'
+// Output: characters written
+// Examples (width 5, fill ' ')
+//     42 to "   42"
+// 123456 to "*****"
+int Format_UDec(char *pt, unsigned long n, unsigned long width, char fill);
+
+//-----------------------Format_SDec-----------------------
+// Signed decimal, the '-' goes in front of the first digit
+// and counts toward the width
+// Input: pt     output buffer, at least width+1 (or 12) bytes
+//        n      32-bit signed number
+//        width  0 for variable size, else right justified field size
+//        fill   ' ' (sign next to digits) or '0' (sign in first column)
+// Output: characters written
+// Examples (width 5)
+//   -42 to "  -42" with fill ' ', "-0042" with fill '0'
+int Format_SDec(char *pt, long n, unsigned long width, char fill);
+
+//-----------------------Format_Fix-----------------------
+// Signed fixed point, n is in units of 10^-decimals and is
+// shown with intdigits zero-padded digits before the point.
+// A '-' is added in front of negative values.
+// Input: pt         output buffer, at least intdigits+decimals+3 bytes
+//        n          32-bit signed fixed-point number
+//        intdigits  1 to 9 digits before the point
+//        decimals   0 to 9 digits after the point
+// Output: characters written
+// Examples (3 digits, 1 decimal)
+//     4 to "000.4"
+//  2210 to "221.0"
+// 10000 to "***.*"
+//   -31 to "-003.1"
+int Format_Fix(char *pt, long n, unsigned long intdigits, unsigned long decimals);
+
+//-----------------------Format_Benchmark-----------------------
+// Time the formatter against the routines it replaced, the
+// recursive Pow() based UART_ConvertAngle() and the divide
+// chain of Nokia5110_OutUDec(), with the DWT cycle counter.
+// Results can be inspected in the debugger watch window.
+// Input: none
+// Output: none
+void Format_Benchmark(void);
+
+extern unsigned long Format_AngleOldCycles;	// average cycles, old "xxx.x" conversion
+extern unsigned long Format_AngleNewCycles;	// average cycles, Format_Fix(pt, n, 3, 1)
+extern unsigned long Format_UDecOldCycles;	// average cycles, old 5-digit divide chain
+extern unsigned long Format_UDecNewCycles;	// average cycles, Format_UDec(pt, n, 5, ' ')
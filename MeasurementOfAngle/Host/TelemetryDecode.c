@@ -0,0 +1,124 @@
+// TelemetryDecode.c
+// Runs on the host PC, not on the LaunchPad
+// Decodes the binary sample stream written by Telemetry.c on
+// the MeasurementOfAngle UART0, checks every packet and reports
+// dropped packets from gaps in the sequence numbers.
+// Enes Kur
+// October 18, 2026
+
+// Build: cc -o TelemetryDecode TelemetryDecode.c
+// Usage: TelemetryDecode [capture.bin]
+// Capture the COM port raw at 1,000,000 8N1 into a file, or pipe
+// it in on stdin.
+// Output, one line per record:
+//   seq,index,word0,word1,...
+// Words are printed as signed 16-bit numbers, MeasurementOfAngle
+// sends the ADC sample, the velocity in deg/s and the
+// acceleration in deg/s^2.
+// Bytes that do not form a valid packet (noise, a capture
+// started mid-packet) are skipped by resynchronizing on the
+// two sync bytes and the CRC.  The summary goes to stderr.
+
+#include <stdio.h>
+
+#define SYNC0 0xA5
+#define SYNC1 0x5A
+#define HEADER 6
+#define MAXWORDS 8
+#define MAXFRAME (HEADER+2*64+2)	// larger than any valid packet
+
+// CRC-16/CCITT, polynomial 0x1021, bitwise
+static unsigned int Crc16(const unsigned char *p, unsigned int n){
+	unsigned int crc, i, b;
+	crc = 0xFFFF;
+	for(i=0; i<n; i++){
+		crc = crc^(p[i]<<8);
+		for(b=0; b<8; b++){
+			crc = (crc&0x8000) ? ((crc<<1)^0x1021) : (crc<<1);
+			crc = crc&0xFFFF;
+		}
+	}
+	return crc;
+}
+
+// Length of the packet starting at f, 0 if the header is not
+// a valid one.  Needs HEADER bytes.
+static unsigned int FrameLength(const unsigned char *f){
+	if((f[0] != SYNC0) || (f[1] != SYNC1)){
+		return 0;
+	}
+	if((f[4] < 1) || (f[4] > MAXWORDS) || (f[5] < 1)){
+		return 0;
+	}
+	if((HEADER + 2*f[4]*f[5] + 2) > MAXFRAME){
+		return 0;
+	}
+	return HEADER + 2*f[4]*f[5] + 2;
+}
+
+// Remove the first k of n buffered bytes
+static void Drop(unsigned char *f, unsigned int *n, unsigned int k){
+	unsigned int i;
+	for(i=k; i<*n; i++){
+		f[i-k] = f[i];
+	}
+	*n = *n - k;
+}
+
+int main(int argc, char **argv){
+	FILE *in;
+	unsigned char f[MAXFRAME];
+	unsigned int n, len, i, j, w, seq, expect, crc;
+	unsigned long packets, dropped, bad, skipped;
+	int c, first;
+
+	in = stdin;
+	if((argc > 1) && ((in = fopen(argv[1], "rb")) == NULL)){
+		perror(argv[1]);
+		return 1;
+	}
+	n = 0; first = 1; expect = 0;
+	packets = 0; dropped = 0; bad = 0; skipped = 0;
+	while((c = fgetc(in)) != EOF){
+		f[n] = (unsigned char)c;
+		n = n + 1;
+		while(n >= HEADER){
+			len = FrameLength(f);
+			if((len != 0) && (n < len)){
+				break;										// wait for the rest of the packet
+			}
+			if(len != 0){
+				crc = Crc16(f+2, len-4);
+				if(crc == (f[len-2] | (f[len-1]<<8))){
+					seq = f[2] | (f[3]<<8);
+					if(!first && (seq != expect)){
+						dropped = dropped + ((seq - expect)&0xFFFF);
+						fprintf(stderr, "gap: expected %u, got %u\n", expect, seq);
+					}
+					first = 0;
+					expect = (seq + 1)&0xFFFF;
+					packets = packets + 1;
+					w = f[4];
+					for(i=0; i<f[5]; i++){
+						printf("%u,%u", seq, i);
+						for(j=0; j<w; j++){
+							printf(",%d", (short)(f[HEADER+2*(i*w+j)] | (f[HEADER+2*(i*w+j)+1]<<8)));
+						}
+						printf("\n");
+					}
+					Drop(f, &n, len);				// consume the packet
+					continue;
+				}
+				bad = bad + 1;							// right framing, wrong CRC
+			}
+			Drop(f, &n, 1);							// slide one byte, look for the next sync
+			skipped = skipped + 1;
+		}
+	}
+	fprintf(stderr, "%lu packets, %lu dropped, %lu CRC errors, %lu bytes skipped\n",
+		packets, dropped, bad, skipped);
+	if(in != stdin){
+		fclose(in);
+	}
+	return 0;
+}
@@ -2,10 +2,43 @@
 // Runs on LM4F120/TM4C123
 // Use SysTick interrupts to periodically initiate a software-
 // triggered ADC conversion, convert the sample to a fixed-
-// point decimal angle, and store the result in a mailbox.
-// The foreground thread takes the result from the mailbox,
+// point decimal angle, and store the result in a FIFO.
+// The foreground thread takes the results from the FIFO,
 // converts the result to a string, and prints it to the
 // Nokia5110 LCD.
+// With TIMER_TRIGGER set, Timer0A starts each conversion in
+// hardware and the ADC0Seq3 interrupt stores the result, so
+// no ISR busy-waits on the ADC and sampling is jitter-free.
+// With SCAN also set, SS0 converts the pot and the on-chip
+// temperature sensor on each trigger, one interrupt per scan.
+// Samples are oversampled (ADC hardware averager) and
+// decimated (CIC filter) before conversion to an angle.
+// Every ADC sample can also be streamed on UART0 (TELEMETRY),
+// decode a capture with Host/TelemetryDecode.c.
+// The LCD is redrawn only when the angle leaves a hysteresis
+// band, and then only the characters that differ.  A bar
+// gauge, a dial needle and a scrolling sparkline are drawn
+// under the text with GRAPHICS set.
+// With ADAPTIVE set the pot is sampled at 1 kHz while it moves
+// and at 125 Hz while it is still, see Rate.h.
+// With WAKE also set, once the pot is still the sampling stops
+// and the ADC digital comparators watch it in hardware, the
+// CPU sleeps until the reading leaves a window around the
+// displayed value or a switch is pressed.
+// With MOTION set the angular velocity and acceleration are
+// estimated from every sample (Motion.h) and shown under the
+// bar gauge and sent with the telemetry.
+// The pot is calibrated with the LaunchPad switches, SW2 starts
+// a capture at known angles, see Calibrate.h.
+// With RTOS set the display and, without TIMER_TRIGGER, the
+// sampling run as threads of the kernel in Common/OS.h, and
+// ADC0_In() and the LCD driver block instead of spinning.
+// With ACTIVE set the display is an active object (Common/AO.h),
+// the sample interrupt posts each new angle and the end of an
+// LCD flush to it, and the CPU sleeps while its queue is empty.
+// The bus runs at 80 MHz from the PLL (Common/Clock.h); with
+// IDLE_PIOSC set it drops to the 16 MHz PIOSC while the
+// comparators watch the pot and the PLL is off.
 // July 3, 2022
 
 /* This example accompanies the book
@@ -22,40 +55,186 @@
 #include "ADC.h"
 #include "..//tm4c123gh6pm.h"
 #include "Nokia5110.h"
+#include "Oversample.h"
+#include "Convert.h"
+#include "Format.h"
+#include "FIFO.h"
+#include "Filter.h"
+#include "Telemetry.h"
+#include "Calibrate.h"
+#include "Rate.h"
+#include "Motion.h"
+#include "..//Common/Clock.h"
+#include "..//Common/OS.h"
+#include "..//Common/AO.h"
 
+#define TIMER_TRIGGER 1		// 1: Timer0A triggers ADC, 0: SysTick ISR triggers ADC
+#define SCAN 1						// 1: with TIMER_TRIGGER, SS0 scans the pot and the temperature sensor
+#define OUTPUT_PERIOD 2000000	// 25 ms in 12.5 ns bus cycles, 40 Hz angle updates
+#define HW_AVERAGE 6			// ADC hardware averaging 2^6 = 64x
+#define DECIMATION 16			// CIC decimation ratio, power of 2
+#define SPIKE_MEDIAN 3		// 0: off, 3 or 5: median of the last 3 or 5 ADC samples
+#define TELEMETRY 1				// 1: stream every ADC sample on UART0 at 1 Mbaud
+#define ADAPTIVE 1				// 1: sample fast while the pot moves, slow when still, 0: SAMPLE_PERIOD
+#define WAKE 1						// 1: with TIMER_TRIGGER and ADAPTIVE, sleep until the pot moves
+#define MOTION 1					// 1: velocity and acceleration on the LCD and in the telemetry
+#define WAKE_WINDOW 6			// ADC LSB either side of the displayed sample, about 0.4 deg
+#define IDLE_PIOSC 1			// 1: with WAKE, run from the 16 MHz PIOSC, PLL off, while watching
+#define RTOS 0						// 1: threads on the preemptive kernel instead of the main loop, no WAKE
+#define ACTIVE 0					// 1: with RTOS 0, display active object instead of the main loop, no WAKE
+												// ADC trigger period, 640 Hz
+#define SAMPLE_PERIOD (OUTPUT_PERIOD/DECIMATION)
+#define BENCHMARK 0				// 1: time Convert and Format against the old routines at startup
+#define LCD_DMA 1					// 1: screen updates over uDMA, 0: interrupt-driven SSI0 queue
+#define HYSTERESIS 2			// 0.1 deg, redraw only when the angle moves more than this
+#define GRAPHICS 1				// 1: bar gauge, dial needle and sparkline under the text
+#define FULL_SCALE 3000		// 0.1 deg, full pot turn, full bar and needle all the way right
+#define DIAL_X 23					// needle pivot at the bottom of the screen
+#define DIAL_Y 47
+#define DIAL_R 22					// needle length in pixels
+#define SPARK_X 48				// sparkline area right of the dial
+#define SPARK_Y 24				// below the velocity row
+#define SPARK_W 36				// one column per sample, 0.9 s of history at 40 Hz
+#define SPARK_H 24
+#define PROMPT_COL (12-CAL_PROMPTLEN)	// calibration prompt at the right of the top row
+
+void DisableInterrupts(void); // Disable interrupts
 void EnableInterrupts(void);  // Enable interrupts
-unsigned long Pow(unsigned long k, unsigned long l);
+void WaitForInterrupt(void);  // low power mode
 
 unsigned char String[10]; // null-terminated ASCII string
-unsigned long Angle;   		// units 0.1 deg
-unsigned long ADCdata;    // 12-bit 0 to 4095 sample
-unsigned long Flag;       // 1 means valid Angle, 0 means Angle is empty
-
-//********Convert****************
-// Convert a 12-bit binary ADC sample into a 32-bit unsigned
-// fixed-point angle (resolution 0.1 deg).  
-// Overflow and dropout should be considered 
-// Input: sample  12-bit ADC sample
-// Output: 32-bit angle (resolution 0.1 deg)
-unsigned long Convert(unsigned long sample){
-  return (0.73*sample);	// 0.73*4095 = 300 degrees which is pot turn amount
-}
+unsigned long Angle;   		// units 0.1 deg, newest value taken from the FIFO
+unsigned long ADCdata;    // 12.4 fixed point 0 to 4095.9375 decimated sample
+struct FilterMedian Spike; // removes single-sample spikes ahead of the decimator
+long Temperature;         // units 0.1 deg C, chip temperature from the last scan
+const unsigned char ScanChannels[2] = {1, ADCSCAN_TEMP}; // pot on Ain1, internal sensor
+unsigned long Shown;      // units 0.1 deg, angle on the screen
+unsigned char ShownString[10]; // characters on the screen, 0 before the first draw
+int Prompting;            // 1 while a calibration prompt covers the units, columns PROMPT_COL-11
+long NeedleDeg = -1;      // dial direction of the needle on the screen, -1 for none
+unsigned short History[SPARK_W]; // recent angles for the sparkline, oldest first
+unsigned char MotionString[13]; // velocity row on the screen
+unsigned long Wakeups;    // times the comparators saw the pot move
+#if RTOS
+struct OS_Sema Decimated; // one unit per angle put in the FIFO
+unsigned long ThreadPeriod = SAMPLE_PERIOD; // SampleThread interval, 12.5 ns units
+#elif ACTIVE
+#define SIG_ANGLE 1				// to Display, an angle went into the FIFO
+#define SIG_FLUSHED 2			// to Display, the last LCD flush is out
+struct AO_Object Display;
+struct AO_Event *DisplayQueue[4];
+int Flushing;             // 1 from Nokia5110_FlushDMA() to SIG_FLUSHED
+int Dirty;                // framebuffer has changes not sent yet
+#endif
 
 // Initialize SysTick interrupts to trigger at 40 Hz, 25 ms
+// period is in 12.5 ns units less one, at any bus clock
 void SysTick_Init(unsigned long period){
 	NVIC_ST_CTRL_R = 0;						// Disable SysTick before init
-	NVIC_ST_RELOAD_R = period; 	// 1999999 ~ 40Hz
+	NVIC_ST_RELOAD_R = Clock_Scale(period+1)-1; 	// 1999999 ~ 40Hz at 80 MHz
 																// priority: 0
 	NVIC_SYS_PRI3_R = NVIC_SYS_PRI3_R & 0x00FFFFFF;
 	NVIC_ST_CTRL_R = 0x00000007;	// Enable SysTick with interrupt
+	Clock_AddListener(&Clock_RescaleSysTick);
+}
+
+// Change the SysTick interrupt interval, from the next reload
+// period is in 12.5 ns units
+void SysTick_SetPeriod(unsigned long period){
+	NVIC_ST_RELOAD_R = Clock_Scale(period)-1;
+}
+
+// Limit to a signed 16-bit telemetry word
+short Clip16(long n){
+	if(n > 32767){
+		return 32767;
+	}
+	if(n < -32768){
+		return -32768;
+	}
+	return n;
+}
+
+//********Sample****************
+// Removes spikes (SPIKE_MEDIAN), adapts the sample rate
+// (ADAPTIVE), estimates velocity and acceleration (MOTION),
+// streams ADC samples (TELEMETRY), decimates them, converts
+// every DECIMATION-th result with the calibration and puts
+// it in the FIFO.
+// Called from SysTick_Handler, ADC0Seq3_Handler or ScanSample.
+// Input: data  12-bit ADC sample, hardware averaged
+// Output: none
+void Sample(unsigned long data){
+#if TELEMETRY
+	unsigned short record[3];
+#endif
+#if SPIKE_MEDIAN
+	data = Filter_Median(&Spike, data);	// 12-bit samples fit Q15
+#endif
+#if ADAPTIVE
+	if(Rate_Put(data)){		// fast on motion, slow after 1 s still
+		Motion_Init(Rate_Hz());	// the window holds samples of the old rate
+	}
+#endif
+#if MOTION
+	Motion_Put(Calibrate_Angle(data<<4));	// about 50 cycles, see Motion.h
+#endif
+#if TELEMETRY
+	record[0] = data;			// every sample, 16 times the display rate
+#if MOTION
+	record[1] = Clip16(Motion_Velocity());
+	record[2] = Clip16(Motion_Accel());
+#endif
+	Telemetry_Put(record);
+#endif
+	if(Oversample_Put(data, &ADCdata)){
+										// Convert 12.4 ADC data to degree format
+										// a full FIFO counts in Fifo_Overflows
+		Fifo_Put(Calibrate_Angle(ADCdata));
+#if RTOS
+		OS_Signal(&Decimated);	// wakes DisplayThread
+#elif ACTIVE
+		AO_Post(&Display, SIG_ANGLE, 0);
+#endif
+	}
+}
+
+//********ScanSample****************
+// Called from ADC0Seq0_Handler with each SS0 scan, the pot
+// goes through the decimator and the temperature is kept.
+// Input: scan  pot sample and temperature sensor sample
+// Output: none
+void ScanSample(const struct ADCScan *scan){
+	Sample(scan->Data[0]);
+	Temperature = ADC0_TempC(scan->Data[1]);
+}
+
+// Called from ADC0Seq2_Handler when the watched reading leaves
+// the window, sampling has already restarted
+void Wake(void){
+	Wakeups++;
 }
-// executes every 25 ms, collects a sample, converts and stores in mailbox
+
+// 1 when no uDMA transfer would be cut by a clock switch,
+// rebaud() and the SSI0 divisor change stop the peripherals
+int ClockQuiet(void){
+#if LCD_DMA
+	if(Nokia5110_FlushBusy()){
+		return 0;
+	}
+#endif
+#if TELEMETRY
+	if(Telemetry_Busy()){
+		return 0;
+	}
+#endif
+	return 1;
+}
+
+// executes every 1.56 ms, collects a sample, converts and stores in FIFO
 void SysTick_Handler(void){
 										// Sample data from ADC
-	ADCdata = ADC0_In();
-										// Convert 12-bit ADC data to degree format
-	Angle = Convert(ADCdata);
-	Flag = 1;					// mailbox is full
+	Sample(ADC0_In());
 }
 
 //-----------------------UART_ConvertAngle-----------------------
@@ -70,73 +249,336 @@ void SysTick_Handler(void){
 // 2210 to "221.0 deg"
 //10000 to "***.* deg"  any value larger than 9999 converted to "***.* deg"
 void UART_ConvertAngle(unsigned long n){
-	unsigned long cnt, cnt1, dec, check, ree;
-	cnt = 0;					// for digits of number
-	cnt1 = 0;					// for chars of string
-	dec = 0;					// for putting dot
-	check = 0;				// check if number < 10000
-	if(n < 10000){
-		check = 1;
-	}
-	// executes 4 times because number has 4 digit
-	while(cnt <= 4){
-		if(check){
-			// number < 10000
-			// adding digits to string
-			ree = n/Pow(10, 3-cnt1);
-			String[cnt] = (ree + 0x30);
-			ree = Pow(10, 3-cnt1);
-			n = n%ree;
+										// 3 digits, point, 1 digit, "***.*" if too big
+	Format_Fix((char *)String, n, 3, 1);
+	String[5] = ' ';		// adding space
+	// adding units
+	String[6] = 'd';
+	String[7] = 'e';
+	String[8] = 'g';
+	String[9] = 0;
+}
+
+//-----------------------Display_Update-----------------------
+// Draws a new angle into the framebuffer only if it moved more
+// than HYSTERESIS from the one on the screen, and then only the
+// characters that differ, plus the gauge and needle with
+// GRAPHICS set.  With the pot at rest nothing is
+// formatted, drawn or sent.
+// Input: angle  32-bit number (resolution 0.1 deg)
+// Output: 1 if anything was drawn, 0 if the screen is unchanged
+int Display_Update(unsigned long angle){
+	unsigned long i, diff;
+	int changed;
+	diff = (angle > Shown) ? (angle - Shown) : (Shown - angle);
+	if(ShownString[0] && (diff <= HYSTERESIS)){
+		return 0;						// within the band, keep the old value
+	}
+	Shown = angle;
+	UART_ConvertAngle(angle);
+	changed = 0;
+	for(i=0; String[i]; i++){
+		if(Prompting && (i >= PROMPT_COL)){
+			break;						// the units are under the prompt
 		}
-		else
-			// number >= 10000
-			// adding stars to string
-			String[cnt] = '*';
-		
-		if(dec == 2){
-			// adding point to string
-			cnt++;
-			String[cnt] = '.';
+		if(String[i] != ShownString[i]){
+										// draw at up-left corner of the framebuffer
+			Nokia5110_BufferChar(i, 0, String[i]);
+			ShownString[i] = String[i];
+			changed = 1;
 		}
-		cnt++;
-		cnt1++;
-		dec++;
 	}
-	
-	String[cnt] = ' ';		// adding space
-	// adding units
-	String[cnt+1] = 'd';
-	String[cnt+2] = 'e';
-	String[cnt+3] = 'g';
+#if GRAPHICS
+	if(NeedleDeg >= 0){		// erase before drawing, needles share the pivot
+		Nokia5110_Needle(DIAL_X, DIAL_Y, DIAL_R, NeedleDeg, 0);
+	}
+										// 0 at the left (180 deg), FULL_SCALE at the right (0 deg)
+	NeedleDeg = 180 - ((((angle < FULL_SCALE) ? angle : FULL_SCALE)*180 + FULL_SCALE/2)/FULL_SCALE);
+	Nokia5110_Needle(DIAL_X, DIAL_Y, DIAL_R, NeedleDeg, 1);
+	Nokia5110_BarGauge(0, 9, 84, 6, angle, FULL_SCALE);
+	changed = 1;
+#endif
+	return changed;
+}
+
+//-----------------------Motion_Update-----------------------
+// Shows velocity in deg/s and acceleration in deg/s^2 on the
+// third row, "v -123a 4567", and draws only the characters
+// that differ from the screen
+// Input: none
+// Output: 1 if anything was drawn, 0 if the screen is unchanged
+int Motion_Update(void){
+	char row[13];
+	unsigned long i;
+	int changed;
+	row[0] = 'v';
+	Format_SDec(&row[1], Motion_Velocity(), 5, ' ');
+	row[6] = 'a';
+	Format_SDec(&row[7], Motion_Accel(), 5, ' ');
+	changed = 0;
+	for(i=0; i<12; i++){
+		if(row[i] != MotionString[i]){
+			Nokia5110_BufferChar(i, 2, row[i]);
+			MotionString[i] = row[i];
+			changed = 1;
+		}
+	}
+	return changed;
 }
 
+//-----------------------Sparkline_Update-----------------------
+// Scrolls the sparkline by one sample.  Redrawing a flat line
+// over itself changes no framebuffer bytes, so nothing is sent
+// while the pot is at rest.
+// Input: angle  32-bit number (resolution 0.1 deg)
+// Output: none
+void Sparkline_Update(unsigned long angle){
+	unsigned long i;
+	for(i=1; i<SPARK_W; i++){
+		History[i-1] = History[i];
+	}
+	History[SPARK_W-1] = (angle < FULL_SCALE) ? angle : FULL_SCALE;
+	Nokia5110_Sparkline(SPARK_X, SPARK_Y, SPARK_W, SPARK_H, History, SPARK_W, 0, FULL_SCALE);
+}
+
+//-----------------------Refresh-----------------------
+// Takes the whole batch from the FIFO, shows the newest angle
+// and reads the switches
+// Input: none
+// Output: 1 if the framebuffer changed, 0 if not or the FIFO was empty
+int Refresh(void){
+	int changed;
+	unsigned long i;
+	char prompt[CAL_PROMPTLEN+1];
+	if(!Fifo_Get(&Angle)){
+		return 0;
+	}
+	while(Fifo_Get(&Angle)){}	// consume the whole batch, show the newest
+												// redraw the digits that changed, if the angle
+												// moved beyond the hysteresis band
+	changed = Display_Update(Angle);
+#if MOTION
+	changed |= Motion_Update();
+#endif
+#if GRAPHICS
+	Sparkline_Update(Angle);
+	changed |= Nokia5110_BufferDirty();
+#endif
+												// switches are read at 40 Hz, debounced
+	if(Calibrate_Poll(ADCdata)){
+		Calibrate_Prompt(prompt);
+		Prompting = (prompt[0] != ' ');
+		for(i=0; i<CAL_PROMPTLEN; i++){	// a blank prompt clears its columns
+			Nokia5110_BufferChar(PROMPT_COL+i, 0, prompt[i]);
+		}
+		if(!Prompting && ShownString[0]){	// give the units back to the angle
+			for(i=PROMPT_COL; String[i]; i++){
+				Nokia5110_BufferChar(i, 0, String[i]);
+				ShownString[i] = String[i];
+			}
+		}
+		changed = 1;
+	}
+	return changed;
+}
+
+#if RTOS
+// Change the SampleThread interval, from its next sample
+void ThreadSetPeriod(unsigned long period){
+	ThreadPeriod = period;
+}
+
+// Samples without TIMER_TRIGGER, ADC0_In() blocks during the
+// conversion and the thread sleeps to the next sample time
+void SampleThread(void){
+	unsigned long next;
+	next = OS_Time();
+	while(1){
+		Sample(ADC0_In());
+		next = next + Clock_Scale(ThreadPeriod);
+		OS_SleepUntil(next);
+	}
+}
+
+// Shows each new angle, the flush blocks while the previous
+// one is still going out
+void DisplayThread(void){
+#if BENCHMARK
+	OS_SwitchBenchmark();	// result in OS_SwitchCycles
+#endif
+	while(1){
+		OS_Wait(&Decimated);
+		if(Refresh()){
+#if LCD_DMA
+			Nokia5110_FlushDMA(0);
+#else
+			Nokia5110_Flush();
+#endif
+		}
+	}
+}
+#endif
+
+#if ACTIVE && !RTOS
+// Called from SSI0_Handler when a flush has gone out
+void Flushed(void){
+	AO_Post(&Display, SIG_FLUSHED, 0);
+}
+
+// Display object, draws each new angle and keeps one flush
+// going at a time, a change during a flush waits for its end
+void Display_Dispatch(const struct AO_Event *e){
+	if(e->Sig == SIG_ANGLE){
+		Dirty |= Refresh();
+	} else{
+		Flushing = 0;
+	}
+#if LCD_DMA
+	if(Dirty && !Flushing){
+		Flushing = 1;
+		Dirty = 0;
+		Nokia5110_FlushDMA(&Flushed);	// Flushed() posts when it is out
+	}
+#else
+	if(Dirty){
+		Nokia5110_Flush();		// queued, returns after the span scan
+		Dirty = 0;
+	}
+#endif
+}
+#endif
+
 int main(void){ 
   volatile unsigned long delay;
-	ADC0_Init();					// initialize ADC0, channel 1, sequencer 3
+	int Pending = 0;			// framebuffer has changes not sent yet
+	int Still = 0;				// newest sample came at the slow rate, the pot is resting
+	DisableInterrupts();	// no samples until the pipeline is set up
+	Clock_Init();					// 80 MHz bus clock from the PLL
+#if BENCHMARK
+	Convert_Benchmark();	// results in Convert_FixCycles, Convert_FloatCycles
+	Format_Benchmark();		// results in Format_AngleOldCycles, Format_AngleNewCycles, ...
+	Nokia5110_GraphicsBenchmark();	// results in Nokia5110_NeedleCycles, Nokia5110_BarCycles, ...
+	Filter_Benchmark();		// results in Filter_Median3Cycles, Filter_BiquadCycles, ...
+	Motion_Benchmark();		// results in Motion_PutCycles, Motion_VelocityError, ...
+#endif
+												// saved calibration from EEPROM, or
+												// 0.73 deg/10 per LSB, 0.73*4095 = 300 degrees pot turn
+	Calibrate_Init();
 	Nokia5110_Init();			// initialize Nokia5110 LCD (optional)
-	SysTick_Init(1999999);// initialize SysTick for 40 Hz interrupts
+	Nokia5110_Clear();		// screen and framebuffer both start blank
+#if LCD_DMA
+	Nokia5110_InitDMA();	// screen updates stream over uDMA
+#else
+	Nokia5110_InitQueue();// screen updates go through the SSI0 interrupt
+#endif
+#if TIMER_TRIGGER && SCAN
+												// initialize ADC0, channel 1 and the temperature
+												// sensor, sequencer 0, started by Timer0A at 640 Hz,
+												// one interrupt per scan
+	ADC0_InitScanSeq0(ScanChannels, 2, SAMPLE_PERIOD, &ScanSample);
+#elif TIMER_TRIGGER
+												// initialize ADC0, channel 1, sequencer 3
+												// started by Timer0A at 640 Hz
+	ADC0_InitTimer0ATriggerSeq3(SAMPLE_PERIOD, &Sample);
+#elif RTOS
+	ADC0_Init();					// initialize ADC0, channel 1, sequencer 3
+												// read by SampleThread
+#else
+	ADC0_Init();					// initialize ADC0, channel 1, sequencer 3
+	SysTick_Init(SAMPLE_PERIOD-1);// initialize SysTick for 640 Hz interrupts
+#endif
+												// 64x hardware averaging, decimate 16:1 to 40 Hz
+												// adds 0.5 ms + 23.4 ms latency, see Oversample_Latency()
+												// (a 2-channel scan takes 1 ms of the 1.56 ms period)
+	Oversample_Init(HW_AVERAGE, DECIMATION);
+	Filter_MedianInit(&Spike, SPIKE_MEDIAN);
+#if ADAPTIVE && TIMER_TRIGGER
+	Rate_Init(&ADC0_SetTriggerPeriod, HW_AVERAGE);	// 1 kHz 16x moving, 125 Hz 64x still
+#if WAKE && !RTOS && !ACTIVE
+	ADC0_InitWatch(&Wake);// SS2 and two comparators, armed when the pot rests
+#endif
+#elif ADAPTIVE && RTOS
+	Rate_Init(&ThreadSetPeriod, HW_AVERAGE);
+#elif ADAPTIVE
+	Rate_Init(&SysTick_SetPeriod, HW_AVERAGE);
+#endif
+#if ADAPTIVE
+	Motion_Init(Rate_Hz());
+#else
+	Motion_Init(CLOCK_REF/SAMPLE_PERIOD);
+#endif
+	Fifo_Init();					// empty sample FIFO
+#if TELEMETRY
+#if MOTION
+	Telemetry_Init(3);		// ADC sample, velocity and acceleration
+#else
+	Telemetry_Init(1);		// one word per record, the ADC sample
+#endif
+#endif
+#if RTOS
+	OS_Init();						// Timer3A time base, no threads yet
+	OS_InitSemaphore(&Decimated, 0);
+#if !TIMER_TRIGGER
+	OS_AddThread(&SampleThread, 0);
+#endif
+	OS_AddThread(&DisplayThread, 1);
+	OS_Launch();					// enables interrupts, never returns
+#elif ACTIVE
+	AO_Init();
+	AO_Start(&Display, &Display_Dispatch, DisplayQueue, 4);
+	AO_Run();							// enables interrupts, never returns
+#endif
 	EnableInterrupts();		// enable interrupts
   while(1){ 
-// read mailbox
+// read FIFO
 // output to Nokia5110 LCD 
-		if(Flag){
-												// convert degree value to string
-			UART_ConvertAngle(Angle); 
-												// start to print up-left corner of Nokia 5110
-			Nokia5110_SetCursor(0, 0);
-												// print the degree value to Nokia 5110
-			Nokia5110_OutString(String);
-			Flag = 0;					// mailbox is used
-		} 
+		if(Fifo_Size()){
+			Pending |= Refresh();
+#if ADAPTIVE
+			Still = !Rate_Fast();
+#endif
+		}
+												// send only the columns that changed; if the
+												// last update is still going, try again later
+#if LCD_DMA
+		if(Pending && !Nokia5110_FlushBusy()){
+			Nokia5110_FlushDMA(0);
+			Pending = 0;
+		}
+#else
+		if(Pending){
+			Nokia5110_Flush();	// queued, returns after the span scan
+			Pending = 0;
+		}
+#endif
+												// sleep until the next interrupt; interrupts are
+												// off so none can slip in between the check and
+												// the sleep, WFI still wakes on a pending one
+		DisableInterrupts();
+		if((Fifo_Size() == 0) && !Pending){
+#if WAKE && TIMER_TRIGGER && ADAPTIVE
+			if(Still){					// pot at rest and the screen is up to date,
+												// stop sampling and watch it in hardware
+				ADC0_Watch((ADCdata>>4 > WAKE_WINDOW) ? (ADCdata>>4)-WAKE_WINDOW : 0,
+				           (ADCdata>>4)+WAKE_WINDOW);
+				Still = 0;
+#if IDLE_PIOSC
+				if(ClockQuiet()){		// else stay at 80 MHz, the next idle tries again
+					Clock_Set(CLOCK_PIOSC, 0);	// nothing to do at 80 MHz until it moves
+				}
+#endif
+			}
+#endif
+			WaitForInterrupt();
+		}
+		EnableInterrupts();		// the interrupt that woke us runs here
+#if WAKE && TIMER_TRIGGER && ADAPTIVE
+		ADC0_WatchStop();			// woken by a switch or the LCD, sample again
+#if IDLE_PIOSC
+		if(Clock_Hz() != CLOCK_REF){
+			Clock_Set(CLOCK_PLL, CLOCK_REF);	// back to 80 MHz before the next sample
+		}
+#endif
+#endif
   }
 }
-
-//-------------------- Pow --------------------
-// takes the exponent with recursive method
-// Inputs: 32-bit base, 32-bit exponent
-// Output: 32-bit calculated number
-unsigned long Pow(unsigned long k, unsigned long l){
-	if(k == 0) return 0;
-	if(l == 0) return 1;
-	return k*Pow(k, l-1);
-}
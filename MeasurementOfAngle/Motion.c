@@ -0,0 +1,124 @@
+// Motion.c
+// Runs on LM4F120/TM4C123
+// Angular velocity and acceleration of the pot from the
+// filtered angle stream.  A quadratic is fitted by least
+// squares to the last MOTION_N angles, its slope and curvature
+// at the window center are the velocity and acceleration.
+// Enes Kur
+// October 18, 2026
+
+#include "Motion.h"
+#include "CycleCount.h"
+
+#define N MOTION_N
+#define U2 ((long)N*(N*N-1)/3)									// sum of u^2
+#define U4 ((long long)N*(N*N-1)*(3*N*N-7)/15)	// sum of u^4
+
+static long Y[N];						// window, Y[Idx] is the oldest angle
+static unsigned long Idx;
+static long S0, S1, S2;			// sum(y), sum(i*y), sum(i^2*y), i = 0 for the oldest
+static long KVel;						// 2*fs/(10*U2), 8.24
+static long KAcc;						// 8*fs^2/(10*(N*U4-U2^2)), 8.24
+static int Empty;						// 1 until the first angle fills the window
+static volatile long Velocity;	// deg/s
+static volatile long Accel;			// deg/s^2
+
+unsigned long Motion_PutCycles;
+long Motion_VelocityError;
+long Motion_AccelError;
+
+// Fill the whole window with one angle, the sums of a constant
+static void fill(long y){
+	unsigned long i;
+	for(i=0; i<N; i++){
+		Y[i] = y;
+	}
+	Idx = 0;
+	S0 = N*y;
+	S1 = ((long)N*(N-1)/2)*y;
+	S2 = ((long)(N-1)*N*(2*N-1)/6)*y;
+	Velocity = 0;
+	Accel = 0;
+}
+
+//------------Motion_Init------------
+// Set the sample rate and empty the window, the next angle
+// fills it (zero velocity).  Call again when the sample rate
+// changes, the old angles were taken at the old rate.
+// A few hundred cycles, it has the only divides.
+// Input: rate  angles per second, 1 to 1000
+// Output: none
+void Motion_Init(unsigned long rate){
+	long long den;
+	den = (long long)N*U4 - (long long)U2*U2;
+	KVel = (long)(((2LL*rate)<<24)/(10*U2));
+	KAcc = (long)((((8LL*rate*rate)<<24) + 5*den)/(10*den));
+	Empty = 1;
+	Velocity = 0;
+	Accel = 0;
+}
+
+//------------Motion_Put------------
+// Slide the window by one angle and update both estimates,
+// runs in the sample ISR
+// Input: angle  0.1 deg
+// Output: none
+void Motion_Put(long angle){
+	long old, r0, su, suu;
+	if(Empty){
+		fill(angle);
+		Empty = 0;
+	}
+	old = Y[Idx];
+	Y[Idx] = angle;
+	Idx = (Idx+1)&(N-1);
+	r0 = S0 - old;											// the oldest angle has i = 0,
+	S2 = S2 - 2*S1 + r0 + (N-1)*(N-1)*angle;	// renumber i-1, the newest gets N-1
+	S1 = S1 - r0 + (N-1)*angle;
+	S0 = r0 + angle;
+	su = 2*S1 - (N-1)*S0;								// sum(u*y), u = 2i-(N-1)
+	suu = 4*S2 - 4*(N-1)*S1 + (N-1)*(N-1)*S0;
+	Velocity = (long)(((long long)su*KVel + 0x800000)>>24);
+	Accel = (long)((((long long)N*suu - (long long)U2*S0)*KAcc + 0x800000)>>24);
+}
+
+//------------Motion_Velocity------------
+// Input: none
+// Output: angular velocity in deg/s, positive with the angle increasing
+long Motion_Velocity(void){
+	return Velocity;
+}
+
+//------------Motion_Accel------------
+// Input: none
+// Output: angular acceleration in deg/s^2
+long Motion_Accel(void){
+	return Accel;
+}
+
+//------------Motion_Benchmark------------
+// Time Motion_Put() with the DWT cycle counter over 1024
+// angles of parabolas and check the estimates against the
+// exact velocity and acceleration at the end.  Leaves the
+// module reset for 1 kHz.  Results can be inspected in the
+// debugger watch window.
+// Input: none
+// Output: none
+void Motion_Benchmark(void){
+	unsigned long n, start, overhead, c;
+	CycleCount_Init();
+	overhead = CycleCount_Overhead();
+	Motion_Init(1000);
+	c = 0;
+	for(n=0; n<1024; n++){							// y = m^2/8 in 0.1 deg at 1 kHz, m = n mod 128
+		start = CycleCount_Get();
+		Motion_Put((long)(((n&127)*(n&127)+4)>>3));
+		c = c + (CycleCount_Get() - start - overhead);
+	}
+	Motion_PutCycles = c/1024;
+																			// exact at the window center, m = 127-(N-1)/2:
+																			// 100*m/4 deg/s and 25000 deg/s^2
+	Motion_VelocityError = Velocity - (long)(((2*127-(N-1))*100+4)/8);
+	Motion_AccelError = Accel - 25000;
+	Motion_Init(1000);
+}
@@ -0,0 +1,67 @@
+// Motion.h
+// Runs on LM4F120/TM4C123
+// Angular velocity and acceleration of the pot from the
+// filtered angle stream.  A quadratic is fitted by least
+// squares to the last MOTION_N angles, its slope and curvature
+// at the window center are the velocity and acceleration.
+// Enes Kur
+// October 18, 2026
+
+// With the window index u = 2i-(N-1), odd and centered,
+//   velocity     = 2*fs*Su/U2
+//   acceleration = 8*fs^2*(N*Suu - U2*S0)/(N*U4 - U2^2)
+// where S0 = sum(y), Su = sum(u*y), Suu = sum(u^2*y) and U2, U4
+// are the sums of u^2 and u^4.  Su and Suu follow from the
+// plain sums S0, S1 = sum(i*y) and S2 = sum(i^2*y), which slide
+// in O(1): drop the oldest angle, renumber the rest, add the
+// newest.  The window ring is only needed to know which angle
+// leaves.  fs and the denominators are folded into two 8.24
+// constants when the rate is set, so a sample costs no divide.
+// Cost per sample at 80 MHz, -O1: about 50 cycles including the
+// call, 0.6 us, 0.06% of the CPU at 1 kHz.  Run
+// Motion_Benchmark() on the board for the actual number.
+// Delay: both estimates are for the window center, (N-1)/2
+// samples old, 15.5 ms at 1 kHz.
+// Range: angles up to 4000 (400.0 deg) keep the sums in 32 bits.
+
+#define MOTION_N 32				// window length, power of 2, at most 32
+
+//------------Motion_Init------------
+// Set the sample rate and empty the window, the next angle
+// fills it (zero velocity).  Call again when the sample rate
+// changes, the old angles were taken at the old rate.
+// A few hundred cycles, it has the only divides.
+// Input: rate  angles per second, 1 to 1000
+// Output: none
+void Motion_Init(unsigned long rate);
+
+//------------Motion_Put------------
+// Slide the window by one angle and update both estimates,
+// runs in the sample ISR
+// Input: angle  0.1 deg
+// Output: none
+void Motion_Put(long angle);
+
+//------------Motion_Velocity------------
+// Input: none
+// Output: angular velocity in deg/s, positive with the angle increasing
+long Motion_Velocity(void);
+
+//------------Motion_Accel------------
+// Input: none
+// Output: angular acceleration in deg/s^2
+long Motion_Accel(void);
+
+//------------Motion_Benchmark------------
+// Time Motion_Put() with the DWT cycle counter over 1024
+// angles of parabolas and check the estimates against the
+// exact velocity and acceleration at the end.  Leaves the
+// module reset for 1 kHz.  Results can be inspected in the
+// debugger watch window.
+// Input: none
+// Output: none
+void Motion_Benchmark(void);
+
+extern unsigned long Motion_PutCycles;	// average cycles per Motion_Put()
+extern long Motion_VelocityError;				// estimate - exact, deg/s
+extern long Motion_AccelError;					// estimate - exact, deg/s^2
@@ -56,6 +56,11 @@
 // back light    (LED, pin 8) not connected, consists of 4 white LEDs which draw ~80mA total
 
 #include "Nokia5110.h"
+#include "Format.h"
+#include "uDMA.h"
+#include "CycleCount.h"
+#include "..//Common/Clock.h"
+#include "..//Common/OS.h"
 // Maximum dimensions of the LCD, although the pixels are
 // numbered from zero to (MAX-1).  Address may automatically
 // be incremented after each transmission.
@@ -78,6 +83,9 @@
 #define SSI0_DR_R               (*((volatile unsigned long *)0x40008008))
 #define SSI0_SR_R               (*((volatile unsigned long *)0x4000800C))
 #define SSI0_CPSR_R             (*((volatile unsigned long *)0x40008010))
+#define SSI0_IM_R               (*((volatile unsigned long *)0x40008014))
+#define SSI0_MIS_R              (*((volatile unsigned long *)0x4000801C))
+#define SSI0_DMACTL_R           (*((volatile unsigned long *)0x40008024))
 #define SSI0_CC_R               (*((volatile unsigned long *)0x40008FC8))
 #define SSI_CR0_SCR_M           0x0000FF00  // SSI Serial Clock Rate
 #define SSI_CR0_SPH             0x00000080  // SSI Serial Clock Phase
@@ -86,11 +94,17 @@
 #define SSI_CR0_FRF_MOTO        0x00000000  // Freescale SPI Frame Format
 #define SSI_CR0_DSS_M           0x0000000F  // SSI Data Size Select
 #define SSI_CR0_DSS_8           0x00000007  // 8-bit data
+#define SSI_CR1_EOT             0x00000010  // End of Transmission
 #define SSI_CR1_MS              0x00000004  // SSI Master/Slave Select
 #define SSI_CR1_SSE             0x00000002  // SSI Synchronous Serial Port
                                             // Enable
 #define SSI_SR_BSY              0x00000010  // SSI Busy Bit
 #define SSI_SR_TNF              0x00000002  // SSI Transmit FIFO Not Full
+#define SSI_IM_TXIM             0x00000008  // SSI Transmit FIFO Interrupt
+                                            // Mask
+#define SSI_MIS_TXMIS           0x00000008  // SSI Transmit FIFO Masked
+                                            // Interrupt Status
+#define SSI_DMACTL_TXDMAE       0x00000002  // Transmit DMA Enable
 #define SSI_CPSR_CPSDVSR_M      0x000000FF  // SSI Clock Prescale Divisor
 #define SSI_CC_CS_M             0x0000000F  // SSI Baud Clock Source
 #define SSI_CC_CS_SYSPLL        0x00000000  // Either the system clock (if the
@@ -100,6 +114,9 @@
 #define SYSCTL_RCGC2_R          (*((volatile unsigned long *)0x400FE108))
 #define SYSCTL_RCGC1_SSI0       0x00000010  // SSI0 Clock Gating Control
 #define SYSCTL_RCGC2_GPIOA      0x00000001  // port A Clock Gating Control
+#define NVIC_EN0_R              (*((volatile unsigned long *)0xE000E100))
+#define NVIC_PRI1_R             (*((volatile unsigned long *)0xE000E404))
+#define SSI0_IRQ                7           // SSI0 interrupt number
 
 
 // This table contains the hex values that represent pixels
@@ -224,12 +241,13 @@ enum typeOfWrite{
 // transmit FIFO, configures the Data/Command pin for data,
 // and then adds the data to the transmit FIFO.
 
-// This is a helper function that sends an 8-bit message to the LCD.
+// This is a helper function that sends an 8-bit message to the
+// LCD, busy-waiting on SSI0.
 // inputs: type     COMMAND or DATA
 //         message  8-bit code to transmit
 // outputs: none
 // assumes: SSI0 and port A have already been initialized and enabled
-void static lcdwrite(enum typeOfWrite type, char message){
+void static lcdwait(enum typeOfWrite type, char message){
   if(type == COMMAND){
                                         // wait until SSI0 not busy/transmit FIFO empty
     while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
@@ -244,17 +262,215 @@ void static lcdwrite(enum typeOfWrite type, char message){
   }
 }
 
+//*************** interrupt-driven queue *****************
+// After Nokia5110_InitQueue() lcdwrite() puts (D/C, byte)
+// pairs into a ring and returns, the SSI0 interrupt moves
+// them to the transmit FIFO.  SSI0 runs in end-of-transmission
+// mode, the TX interrupt means the FIFO is empty and the last
+// bit has left the shift register.  With nothing in flight the
+// handler can set the Data/Command pin for the next entry and
+// load up to 8 bytes of the same type, it stops early at a
+// command/data boundary.  A full FIFO of data costs one
+// interrupt per 19 us at 3.33 Mbps, the link idles for the
+// interrupt latency between bursts.
+// The foreground waits only when the ring is full, a thread of
+// the kernel in Common/OS.h blocks until there is room.
+#define LCDQSIZE 512                    // power of 2, holds a full screen plus commands
+#define LCDQMASK (LCDQSIZE-1)
+#define LCDQDATA 0x100                  // entry bit 8 is the D/C flag
+static unsigned short LcdQ[LCDQSIZE];
+static volatile unsigned long LcdQPut;  // written by the foreground only
+static volatile unsigned long LcdQGet;  // written by SSI0_Handler only
+static int QueueOn;                     // 1 after Nokia5110_InitQueue()
+static volatile int FlushActive;        // 1 while a uDMA flush owns SSI0
+static struct OS_Sema LcdProgress;      // signaled by SSI0_Handler for a waiting thread
+static volatile int LcdWaiting;         // 1 while a thread waits on LcdProgress
+
+// Wait while busy() returns 1.  A thread of the kernel in
+// Common/OS.h blocks and SSI0_Handler wakes it after each step
+// to check again, before the launch this spins.
+static void lcdblock(int (*busy)(void)){
+  while((*busy)()){
+    if(OS_Running()){
+      LcdWaiting = 1;
+      if((*busy)()){                    // not finished since the flag was set
+        OS_Wait(&LcdProgress);
+      }
+    }
+  }
+}
+
+// 1 while the ring has no room
+static int lcdqfull(void){
+  return (LcdQPut-LcdQGet) >= LCDQSIZE;
+}
+
+// Make sure the interrupt runs, it fires at once if SSI0 is
+// idle.  A uDMA flush in progress starts the queue when it is done.
+static void lcdarm(void){
+  if(!FlushActive){
+    SSI0_IM_R = SSI_IM_TXIM;
+  }
+}
+
+// Add a message to the ring and arm the interrupt
+static void lcdqueue(enum typeOfWrite type, char message){
+  lcdblock(&lcdqfull);                  // ring full, SSI0_Handler makes room
+  LcdQ[LcdQPut&LCDQMASK] = (type == DATA) ? (LCDQDATA|(unsigned char)message)
+                                          : (unsigned char)message;
+  LcdQPut = LcdQPut + 1;                // publish after the entry is written
+  lcdarm();
+}
+
+// Called from SSI0_Handler with the FIFO empty and SSI0 idle.
+// Sends the next run of one type, disarms when the ring is empty.
+static void lcdrefill(void){
+  unsigned long n;
+  unsigned short type;
+  if(LcdQGet == LcdQPut){
+    SSI0_IM_R = 0;                      // all sent, SSI0 idle
+    return;
+  }
+  type = LcdQ[LcdQGet&LCDQMASK]&LCDQDATA;
+  DC = type ? DC_DATA : DC_COMMAND;     // safe, nothing is being shifted out
+  n = 0;
+  while((n < 8) && (LcdQGet != LcdQPut) &&
+        ((LcdQ[LcdQGet&LCDQMASK]&LCDQDATA) == type)){
+    SSI0_DR_R = LcdQ[LcdQGet&LCDQMASK]&0xFF;
+    LcdQGet = LcdQGet + 1;
+    n = n + 1;
+  }
+}
+
+// This is a helper function that sends an 8-bit message to the
+// LCD, through the queue once Nokia5110_InitQueue() was called.
+// inputs: type     COMMAND or DATA
+//         message  8-bit code to transmit
+// outputs: none
+// assumes: SSI0 and port A have already been initialized and enabled
+void static lcdwrite(enum typeOfWrite type, char message){
+  if(QueueOn){
+    lcdqueue(type, message);
+  } else{
+    lcdwait(type, message);
+  }
+}
+
+// Send a run of data bytes with one mode check and one D/C
+// setting, instead of one lcdwrite() call per byte.
+// inputs: buf  bytes to send
+//         n    number of bytes
+// outputs: none
+static void lcdburst(const char *buf, unsigned long n){
+  unsigned long i;
+  if(QueueOn){
+    for(i=0; i<n; i=i+1){
+      if(lcdqfull()){
+        lcdarm();                       // ring full, let SSI0_Handler make room
+        lcdblock(&lcdqfull);
+      }
+      LcdQ[LcdQPut&LCDQMASK] = LCDQDATA|(unsigned char)buf[i];
+      LcdQPut = LcdQPut + 1;
+    }
+    lcdarm();
+  } else{
+    DC = DC_DATA;                       // a command write leaves SSI0 idle
+    for(i=0; i<n; i=i+1){
+      while((SSI0_SR_R&SSI_SR_TNF)==0){}; // wait until transmit FIFO not full
+      SSI0_DR_R = buf[i];               // data out
+    }
+  }
+}
+
+//*************** glyph cache *****************
+// Every character is sent as 7 columns, a blank column, the 5
+// font columns and another blank column.  Nokia5110_Init()
+// copies the font into this table with the padding in place,
+// 672 bytes of RAM, so drawing a character is a 7-byte copy.
+// Strings are rendered into one buffer and sent with a
+// single lcdburst(), at 80 MHz roughly 20 cycles per byte
+// instead of the 40-50 a separate lcdwrite() call took.
+#define GLYPHWIDTH 7                    // columns per character
+#define FONTFIRST 0x20                  // first character in ASCII[]
+#define FONTLAST 0x7F                   // last character in ASCII[]
+static char Glyph[FONTLAST-FONTFIRST+1][GLYPHWIDTH];
+
+// Build the padded glyphs from the font table
+static void glyphinit(void){
+  unsigned long c, i;
+  for(c=0; c<=(FONTLAST-FONTFIRST); c=c+1){
+    Glyph[c][0] = 0x00;                 // blank vertical line padding
+    for(i=0; i<5; i=i+1){
+      Glyph[c][i+1] = ASCII[c][i];
+    }
+    Glyph[c][6] = 0x00;                 // blank vertical line padding
+  }
+}
+
+// Padded glyph of a character, outside the font a blank
+static const char *glyph(unsigned char data){
+  if((data < FONTFIRST) || (data > FONTLAST)){
+    data = ' ';
+  }
+  return Glyph[data-FONTFIRST];
+}
+
+// Render up to max characters of a string into buf,
+// GLYPHWIDTH bytes each.
+// inputs: buf  output, at least max*GLYPHWIDTH bytes
+//         ptr  pointer to NULL-terminated ASCII string
+//         max  characters to render at most
+// outputs: number of characters rendered
+static unsigned long render(char *buf, const unsigned char *ptr, unsigned long max){
+  unsigned long cnt, i;
+  const char *g;
+  cnt = 0;
+  while(ptr[cnt] && (cnt < max)){
+    g = glyph(ptr[cnt]);
+    for(i=0; i<GLYPHWIDTH; i=i+1){
+      buf[i] = g[i];
+    }
+    buf = buf + GLYPHWIDTH;
+    cnt = cnt + 1;
+  }
+  return cnt;
+}
+
+// SSI0 prescaler for an SSIClk of at most 3.33 MHz, the PCD8544
+// takes up to 4 MHz: SysClk/CPSDVSR rounded up to an even number,
+// 24 at 80 MHz, 6 (2.67 MHz) at 16 MHz
+static unsigned long cpsdvsr(unsigned long hz){
+  unsigned long div;
+  div = (hz + 3333332)/3333333;
+  div = (div + 1)&~1;                   // must be even number
+  if(div < 2){
+    div = 2;
+  }
+  return div;
+}
+
+// Keep SSIClk in range across a clock change
+static void ssiclock(unsigned long hz, unsigned long oldhz){
+  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};// finish the byte being shifted
+  SSI0_CR1_R &= ~SSI_CR1_SSE;           // disable SSI
+  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+cpsdvsr(hz);
+  SSI0_CR1_R |= SSI_CR1_SSE;            // enable SSI
+}
+
 //********Nokia5110_Init*****************
 // Initialize Nokia 5110 48x84 LCD by sending the proper
 // commands to the PCD8544 driver.  One new feature of the
 // LM4F120 is that its SSIs can get their baud clock from
 // either the system clock or from the 16 MHz precision
-// internal oscillator.
+// internal oscillator.  The divisor is derived from Clock_Hz()
+// and follows clock changes, so the SSI clock stays under the
+// 4 MHz maximum of the Nokia 5110 at any bus clock.
 // inputs: none
 // outputs: none
-// assumes: system clock rate of 80 MHz
+// assumes: Clock_Init() or Clock_Set() has set the system clock
 void Nokia5110_Init(void){
   volatile unsigned long delay;
+  glyphinit();                          // padded font in RAM
   SYSCTL_RCGC1_R |= SYSCTL_RCGC1_SSI0;  // activate SSI0
   SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOA; // activate port A
   delay = SYSCTL_RCGC2_R;               // allow time to finish activating
@@ -271,10 +487,11 @@ void Nokia5110_Init(void){
   SSI0_CR1_R &= ~SSI_CR1_MS;            // master mode
                                         // configure for system clock/PLL baud clock source
   SSI0_CC_R = (SSI0_CC_R&~SSI_CC_CS_M)+SSI_CC_CS_SYSPLL;
-                                        // clock divider for 3.33 MHz SSIClk (80 MHz PLL/24)
+                                        // clock divider for 3.33 MHz SSIClk (80 MHz PLL/24),
+                                        // follows the bus clock, see cpsdvsr()
                                         // SysClk/(CPSDVSR*(1+SCR))
                                         // 80/(24*(1+0)) = 3.33 MHz (slower than 4 MHz)
-  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+24; // must be even number
+  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+cpsdvsr(Clock_Hz()); // must be even number
   SSI0_CR0_R &= ~(SSI_CR0_SCR_M |       // SCR = 0 (3.33 Mbps data rate)
                   SSI_CR0_SPH |         // SPH = 0
                   SSI_CR0_SPO);         // SPO = 0
@@ -296,6 +513,7 @@ void Nokia5110_Init(void){
 
   lcdwrite(COMMAND, 0x20);              // we must send 0x20 before modifying the display control mode
   lcdwrite(COMMAND, 0x0C);              // set display control to normal mode: 0x0D for inverse
+  Clock_AddListener(&ssiclock);         // keep SSIClk under 4 MHz at any bus clock
 }
 
 //********Nokia5110_OutChar*****************
@@ -306,30 +524,31 @@ void Nokia5110_Init(void){
 // One blank column of pixels will be printed on either side
 // of the character for readability.  Since characters are 8
 // pixels tall and 5 pixels wide, 12 characters fit per row,
-// and there are six rows.
+// and there are six rows.  Characters outside 0x20 to 0x7F
+// are printed as a blank.
 // inputs: data  character to print
 // outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutChar(unsigned char data){
-  int i;
-  lcdwrite(DATA, 0x00);                 // blank vertical line padding
-  for(i=0; i<5; i=i+1){
-    lcdwrite(DATA, ASCII[data - 0x20][i]);
-  }
-  lcdwrite(DATA, 0x00);                 // blank vertical line padding
+  lcdburst(glyph(data), GLYPHWIDTH);    // padding is part of the glyph
 }
 
 //********Nokia5110_OutString*****************
 // Print a string of characters to the Nokia 5110 48x84 LCD.
 // The string will automatically wrap, so padding spaces may
-// be needed to make the output look optimal.
+// be needed to make the output look optimal.  Up to a row of
+// 12 characters is rendered and sent as one burst.
+// Characters outside 0x20 to 0x7F are printed as a blank.
 // inputs: ptr  pointer to NULL-terminated ASCII string
 // outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutString(unsigned char *ptr){
+  char buf[12*GLYPHWIDTH];              // one row of glyphs
+  unsigned long cnt;
   while(*ptr){
-    Nokia5110_OutChar((unsigned char)*ptr);
-    ptr = ptr + 1;
+    cnt = render(buf, ptr, 12);
+    lcdburst(buf, cnt*GLYPHWIDTH);
+    ptr = ptr + cnt;
   }
 }
 
@@ -340,39 +559,9 @@ void Nokia5110_OutString(unsigned char *ptr){
 // Outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutUDec(unsigned short n){
-  if(n < 10){
-    Nokia5110_OutString("    ");
-    Nokia5110_OutChar(n+'0'); /* n is between 0 and 9 */
-  } else if(n<100){
-    Nokia5110_OutString("   ");
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  } else if(n<1000){
-    Nokia5110_OutString("  ");
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
-  else if(n<10000){
-    Nokia5110_OutChar(' ');
-    Nokia5110_OutChar(n/1000+'0'); /* thousands digit */
-    n = n%1000;
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
-  else {
-    Nokia5110_OutChar(n/10000+'0'); /* ten-thousands digit */
-    n = n%10000;
-    Nokia5110_OutChar(n/1000+'0'); /* thousands digit */
-    n = n%1000;
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
+  char buf[6];
+  Format_UDec(buf, n, 5, ' ');          // reciprocal multiply, no divides
+  Nokia5110_OutString((unsigned char *)buf);
 }
 
 //********Nokia5110_SetCursor*****************
@@ -416,3 +605,612 @@ void Nokia5110_DrawFullImage(const char *ptr){
     lcdwrite(DATA, ptr[i]);
   }
 }
+
+//*************** RAM framebuffer *****************
+// Screen[] is a copy of the 504 bytes of display RAM, one
+// byte is 8 vertical pixels of one column in one bank
+// (bank = 8-pixel row, 6 banks of 84 columns).  Draw calls
+// only change Screen[] and set a bit in Dirty[] for every
+// byte whose value really changed, so redrawing the same
+// text costs nothing.  Nokia5110_Flush() then sends only the
+// changed spans.  Do not mix the buffer with the direct
+// Nokia5110_OutChar() family on the same area of the screen,
+// the buffer does not know what they wrote.
+#define BANKS                   (MAX_Y/8)
+#define DIRTYWORDS              ((MAX_X+31)/32)
+// Flush merges two dirty spans in a bank when they are at most
+// MERGE_GAP clean columns apart.  Resending a clean byte costs
+// one byte time on SSI0, repositioning costs one or two command
+// bytes plus draining the FIFO, which takes longer.
+#define MERGE_GAP               3
+static char Screen[MAX_X*BANKS];
+static unsigned long Dirty[BANKS][DIRTYWORDS];
+
+// Store a byte in the framebuffer and mark it dirty if it changed
+// inputs: x  column 0 to 83
+//         y  bank 0 to 5
+//         data  8 vertical pixels, LSB on top
+// outputs: none
+static void bufwrite(unsigned long x, unsigned long y, char data){
+  if(Screen[y*MAX_X+x] != data){
+    Screen[y*MAX_X+x] = data;
+    Dirty[y][x>>5] |= 1<<(x&0x1F);
+  }
+}
+
+// Column x of bank y has changed since the last flush
+static int isdirty(unsigned long x, unsigned long y){
+  return (Dirty[y][x>>5]>>(x&0x1F))&1;
+}
+
+//********Nokia5110_ClearBuffer*****************
+// Clear the framebuffer.  The screen changes at the next
+// Nokia5110_Flush(), only columns that were not blank are sent.
+// inputs: none
+// outputs: none
+void Nokia5110_ClearBuffer(void){
+  unsigned long x, y;
+  for(y=0; y<BANKS; y=y+1){
+    for(x=0; x<MAX_X; x=x+1){
+      bufwrite(x, y, 0x00);
+    }
+  }
+}
+
+//********Nokia5110_BufferChar*****************
+// Draw a character into the framebuffer, 7 columns wide with
+// one blank column of padding on either side.
+// inputs: x     character column 0 to 11
+//         y     character row 0 to 5
+//         data  character to draw, 0x20 to 0x7F
+// outputs: none
+void Nokia5110_BufferChar(unsigned char x, unsigned char y, unsigned char data){
+  unsigned long col, i;
+  const char *g;
+  if((x > 11) || (y > 5) || (data < FONTFIRST) || (data > FONTLAST)){
+    return;                             // bad input, do nothing
+  }
+  col = x*GLYPHWIDTH;
+  g = Glyph[data-FONTFIRST];            // padding is part of the glyph
+  for(i=0; i<GLYPHWIDTH; i=i+1){
+    bufwrite(col+i, y, g[i]);
+  }
+}
+
+//********Nokia5110_BufferString*****************
+// Draw a string into the framebuffer starting at a character
+// position.  The string wraps to the next row and back to the top.
+// inputs: x    character column 0 to 11
+//         y    character row 0 to 5
+//         ptr  pointer to NULL-terminated ASCII string
+// outputs: none
+void Nokia5110_BufferString(unsigned char x, unsigned char y, unsigned char *ptr){
+  while(*ptr){
+    Nokia5110_BufferChar(x, y, *ptr);
+    ptr = ptr + 1;
+    x = x + 1;
+    if(x > 11){
+      x = 0;
+      y = (y+1)%6;
+    }
+  }
+}
+
+//*************** graphics primitives *****************
+// Pixel graphics on the framebuffer, integer math only.  x is
+// the pixel column 0 to 83 (left to right), y the pixel row 0
+// to 47 (top to bottom).  Pixels off the screen are clipped.
+// color is 1 to set pixels (black) and 0 to clear them.
+// Expected cost at 80 MHz, -O1, run Nokia5110_GraphicsBenchmark()
+// on the board for the actual numbers
+// pixel            about 25 cycles
+// line             about 30 cycles per pixel of the longer axis
+// needle r=22      about 800 cycles
+// bar gauge 84x6   about 2500 cycles, one byte per column
+// sparkline 36x30  about 8000 cycles, clear plus 35 segments
+// A 40 Hz refresh leaves 2,000,000 cycles per frame.
+
+// sin(0 to 90 deg) in 1 deg steps, 2.14 fixed point
+static const unsigned short SinTable[91] = {
+  0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+  2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+  5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+  8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+  10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+  12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+  14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+  15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+  16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+  16384
+};
+
+// Set or clear the pixels of bank b in column x given by mask
+static void bitsbyte(unsigned long x, unsigned long b, unsigned char mask, int color){
+  char data;
+  data = Screen[b*MAX_X+x];
+  bufwrite(x, b, color ? (data|mask) : (data&~mask));
+}
+
+// Set or clear one pixel, clipped to the screen
+static void pixel(long x, long y, int color){
+  if((x < 0) || (x >= MAX_X) || (y < 0) || (y >= MAX_Y)){
+    return;
+  }
+  bitsbyte(x, y>>3, 1<<(y&7), color);
+}
+
+// Set or clear column x from row y0 down to row y1, one byte
+// per bank instead of one per pixel
+static void vline(long x, long y0, long y1, int color){
+  unsigned long b, lo, hi;
+  if(y0 < 0) y0 = 0;
+  if(y1 >= MAX_Y) y1 = MAX_Y-1;
+  if((x < 0) || (x >= MAX_X) || (y0 > y1)){
+    return;
+  }
+  for(b=y0>>3; b<=(unsigned long)(y1>>3); b=b+1){
+    lo = (y0 > (long)(b*8)) ? (y0&7) : 0;
+    hi = (y1 < (long)(b*8+7)) ? (y1&7) : 7;
+    bitsbyte(x, b, (0xFF<<lo)&(0xFF>>(7-hi)), color);
+  }
+}
+
+//********Nokia5110_SetPxl*****************
+// Turn on one pixel in the framebuffer
+// inputs: x  column 0 to 83
+//         y  row 0 to 47
+// outputs: none
+void Nokia5110_SetPxl(long x, long y){
+  pixel(x, y, 1);
+}
+
+//********Nokia5110_ClrPxl*****************
+// Turn off one pixel in the framebuffer
+// inputs: x  column 0 to 83
+//         y  row 0 to 47
+// outputs: none
+void Nokia5110_ClrPxl(long x, long y){
+  pixel(x, y, 0);
+}
+
+//********Nokia5110_Line*****************
+// Draw a line with Bresenham's algorithm, adds and compares
+// only, both end points included.
+// inputs: x0,y0  start pixel
+//         x1,y1  end pixel
+//         color  1 to set, 0 to clear
+// outputs: none
+void Nokia5110_Line(long x0, long y0, long x1, long y1, int color){
+  long dx, dy, sx, sy, err, e2;
+  dx = (x1 > x0) ? (x1-x0) : (x0-x1);
+  dy = (y1 > y0) ? (y0-y1) : (y1-y0);   // negative
+  sx = (x0 < x1) ? 1 : -1;
+  sy = (y0 < y1) ? 1 : -1;
+  err = dx + dy;
+  while(1){
+    pixel(x0, y0, color);
+    if((x0 == x1) && (y0 == y1)){
+      return;
+    }
+    e2 = 2*err;
+    if(e2 >= dy){                       // step in x
+      err = err + dy;
+      x0 = x0 + sx;
+    }
+    if(e2 <= dx){                       // step in y
+      err = err + dx;
+      y0 = y0 + sy;
+    }
+  }
+}
+
+//********Nokia5110_FillRect*****************
+// Set or clear a rectangle of pixels
+// inputs: x,y    top left pixel
+//         w,h    width and height in pixels
+//         color  1 to set, 0 to clear
+// outputs: none
+void Nokia5110_FillRect(long x, long y, long w, long h, int color){
+  long i;
+  for(i=0; i<w; i=i+1){
+    vline(x+i, y, y+h-1, color);
+  }
+}
+
+//********Nokia5110_Sin*****************
+// Sine from a quarter-wave table, 1 deg resolution
+// inputs: deg  angle in degrees, any value
+// outputs: sin(deg) in 2.14 fixed point, -16384 to 16384
+long Nokia5110_Sin(long deg){
+  deg = deg%360;
+  if(deg < 0) deg = deg + 360;
+  if(deg <= 90) return SinTable[deg];
+  if(deg <= 180) return SinTable[180-deg];
+  if(deg <= 270) return -(long)SinTable[deg-180];
+  return -(long)SinTable[360-deg];
+}
+
+//********Nokia5110_Cos*****************
+// Cosine from the same table, cos(deg) = sin(deg+90)
+// inputs: deg  angle in degrees, any value
+// outputs: cos(deg) in 2.14 fixed point, -16384 to 16384
+long Nokia5110_Cos(long deg){
+  return Nokia5110_Sin(deg+90);
+}
+
+//********Nokia5110_Needle*****************
+// Draw a dial needle from the center out to radius r
+// inputs: cx,cy  center pixel
+//         r      length in pixels
+//         deg    direction in degrees, 0 points right,
+//                90 points up (counterclockwise)
+//         color  1 to draw, 0 to erase
+// outputs: none
+void Nokia5110_Needle(long cx, long cy, long r, long deg, int color){
+  long x, y;                            // round 2.14 products to pixels
+  x = cx + ((r*Nokia5110_Cos(deg) + 8192)>>14);
+  y = cy - ((r*Nokia5110_Sin(deg) + 8192)>>14);
+  Nokia5110_Line(cx, cy, x, y, color);
+}
+
+//********Nokia5110_BarGauge*****************
+// Draw a horizontal bar gauge with a 1-pixel frame, filled
+// from the left in proportion to value/max
+// inputs: x,y    top left pixel of the frame
+//         w,h    size of the frame, at least 3x3
+//         value  0 to max, larger values show a full bar
+//         max    full scale, greater than 0
+// outputs: none
+void Nokia5110_BarGauge(long x, long y, long w, long h, unsigned long value, unsigned long max){
+  unsigned long fill, i;
+  if(value > max){
+    value = max;
+  }
+  fill = (value*(w-2) + max/2)/max;     // inside columns to fill, rounded
+  vline(x, y, y+h-1, 1);                // frame left
+  vline(x+w-1, y, y+h-1, 1);            // frame right
+  for(i=0; i<(unsigned long)(w-2); i=i+1){
+    vline(x+1+i, y+1, y+h-2, (i < fill));
+    pixel(x+1+i, y, 1);                 // frame top
+    pixel(x+1+i, y+h-1, 1);             // frame bottom
+  }
+}
+
+//********Nokia5110_Sparkline*****************
+// Draw a line graph of recent samples into a rectangle,
+// oldest on the left, one column per sample.  The rectangle
+// is cleared first, so calling it with the history shifted by
+// one sample scrolls the graph.
+// inputs: x,y      top left pixel
+//         w,h      size in pixels, h at least 2
+//         samples  n values, oldest first
+//         n        number of samples, at most w are drawn
+//         min,max  values at the bottom and the top, min < max
+// outputs: none
+void Nokia5110_Sparkline(long x, long y, long w, long h, const unsigned short *samples,
+                         unsigned long n, unsigned short min, unsigned short max){
+  unsigned long i, s;
+  long py, lasty;
+  Nokia5110_FillRect(x, y, w, h, 0);
+  if(n > (unsigned long)w){
+    samples = samples + (n-w);          // newest w samples
+    n = w;
+  }
+  lasty = 0;
+  for(i=0; i<n; i=i+1){
+    s = samples[i];
+    if(s < min) s = min;
+    if(s > max) s = max;
+                                        // scale to rows, max at the top
+    py = y + h - 1 - (long)(((s-min)*(h-1) + (max-min)/2)/(max-min));
+    if(i == 0){
+      pixel(x, py, 1);
+    } else{
+      Nokia5110_Line(x+i-1, lasty, x+i, py, 1);
+    }
+    lasty = py;
+  }
+}
+
+unsigned long Nokia5110_LineCycles;
+unsigned long Nokia5110_NeedleCycles;
+unsigned long Nokia5110_BarCycles;
+unsigned long Nokia5110_SparkCycles;
+
+//********Nokia5110_GraphicsBenchmark*****************
+// Time the primitives with the DWT cycle counter, at the
+// sizes the angle display uses.  The framebuffer is cleared
+// afterward.  Results can be inspected in the debugger watch
+// window.
+// inputs: none
+// outputs: none
+void Nokia5110_GraphicsBenchmark(void){
+  unsigned short history[36];
+  unsigned long i, start, overhead;
+  for(i=0; i<36; i=i+1){
+    history[i] = (i*83)&0x7FF;          // busy zig-zag, worst case for lines
+  }
+  CycleCount_Init();
+  overhead = CycleCount_Overhead();
+  start = CycleCount_Get();
+  Nokia5110_Line(0, 0, MAX_X-1, MAX_Y-1, 1);
+  Nokia5110_LineCycles = CycleCount_Get() - start - overhead;
+  start = CycleCount_Get();
+  Nokia5110_Needle(23, 47, 22, 45, 1);
+  Nokia5110_NeedleCycles = CycleCount_Get() - start - overhead;
+  start = CycleCount_Get();
+  Nokia5110_BarGauge(0, 9, MAX_X, 6, 1500, 3000);
+  Nokia5110_BarCycles = CycleCount_Get() - start - overhead;
+  start = CycleCount_Get();
+  Nokia5110_Sparkline(48, 18, 36, 30, history, 36, 0, 0x7FF);
+  Nokia5110_SparkCycles = CycleCount_Get() - start - overhead;
+  Nokia5110_ClearBuffer();
+  Nokia5110_ClearDirty();
+}
+
+// One run of changed bytes in a bank, with the cursor
+// commands needed in front of it (0 means not needed)
+struct Span{
+  unsigned short Start;                 // index into Screen[]
+  unsigned char Length;                 // 1 to 84 bytes
+  unsigned char CmdY;                   // 0x40|bank or 0
+  unsigned char CmdX;                   // 0x80|column or 0
+};
+                                        // worst case, 1 dirty byte every MERGE_GAP+2 columns
+#define MAXSPANS                (((MAX_X+MERGE_GAP+1)/(MERGE_GAP+2))*BANKS)
+static struct Span Spans[MAXSPANS];
+static unsigned long NumSpans;
+
+// Scan Dirty[] into Spans[] and clear it.  Each bank is scanned
+// for dirty columns, spans closer than MERGE_GAP are merged, and
+// a cursor command is only kept when the LCD address pointer is
+// not already at the start of the span (it auto-increments, and
+// wraps to the next bank after column 83).
+// outputs: number of data bytes in the spans
+static unsigned long findspans(void){
+  unsigned long x, y, start, end, gap, i, bytes;
+  unsigned long curX, curY;             // LCD address pointer, MAX_X is unknown
+  curX = MAX_X; curY = BANKS;           // direct writes may have moved it
+  NumSpans = 0;
+  bytes = 0;
+  for(y=0; y<BANKS; y=y+1){
+    x = 0;
+    while(x < MAX_X){
+      while((x < MAX_X) && !isdirty(x, y)){
+        x = x + 1;                      // find the start of a span
+      }
+      if(x == MAX_X){
+        break;
+      }
+      start = x;
+      end = x;
+      gap = 0;
+      for(x=x+1; (x < MAX_X) && (gap <= MERGE_GAP); x=x+1){
+        if(isdirty(x, y)){
+          end = x;                      // extend span over a short clean gap
+          gap = 0;
+        } else{
+          gap = gap + 1;
+        }
+      }
+      x = end + 1;
+      Spans[NumSpans].Start = y*MAX_X + start;
+      Spans[NumSpans].Length = end - start + 1;
+      Spans[NumSpans].CmdY = (curY != y) ? (0x40|y) : 0;
+      Spans[NumSpans].CmdX = (curX != start) ? (0x80|start) : 0;
+      NumSpans = NumSpans + 1;
+      bytes = bytes + end - start + 1;
+      curX = end + 1;
+      curY = y;
+      if(curX == MAX_X){                // address pointer wraps
+        curX = 0;
+        curY = (y+1)%BANKS;
+      }
+    }
+    for(i=0; i<DIRTYWORDS; i=i+1){
+      Dirty[y][i] = 0;
+    }
+  }
+  return bytes;
+}
+
+// Send the cursor commands in front of a span, if any, with
+// lcdwrite() (queued or blocking) or lcdwait() (blocking).
+static void spancommands(const struct Span *sp, void (*write)(enum typeOfWrite, char)){
+  if(sp->CmdY){
+    (*write)(COMMAND, sp->CmdY);        // setting bit 6 updates Y-position
+  }
+  if(sp->CmdX){
+    (*write)(COMMAND, sp->CmdX);        // setting bit 7 updates X-position
+  }
+}
+
+//********Nokia5110_Flush*****************
+// Send the changed parts of the framebuffer to the LCD with
+// the fewest cursor commands, busy-waiting on SSI0 or, after
+// Nokia5110_InitQueue(), through the interrupt-driven queue.
+// When one digit of the angle string changes this sends at
+// most 5 data bytes and 2 commands instead of rewriting the
+// 63 bytes of the whole string.
+// inputs: none
+// outputs: number of data bytes sent
+// assumes: LCD is in default horizontal addressing mode (V = 0)
+unsigned long Nokia5110_Flush(void){
+  unsigned long i, j, bytes;
+  lcdblock(&Nokia5110_FlushBusy);       // let a DMA flush finish first
+  bytes = findspans();
+  for(i=0; i<NumSpans; i=i+1){
+    spancommands(&Spans[i], &lcdwrite);
+    for(j=0; j<Spans[i].Length; j=j+1){
+      lcdwrite(DATA, Screen[Spans[i].Start+j]);
+    }
+  }
+  return bytes;
+}
+
+//*************** uDMA transmit path *****************
+// Nokia5110_FlushDMA() streams the spans to SSI0 on uDMA
+// channel 11.  Each span is one basic-mode transfer, the
+// completion interrupt (SSI0_Handler) sends the cursor
+// commands of the next span and starts it.  The foreground
+// only runs the span scan.  The handler waits for the FIFO to
+// drain before a cursor command, at most 8 bytes or 19 us at
+// 3.33 Mbps, instead of the 1.2 ms a full screen takes.
+// Drawing during a DMA flush is allowed, bytes that change
+// after they were sent are dirty again for the next flush.
+static unsigned long SpanI;             // span being transferred
+static void (*FlushDone)(void);         // user callback, may be 0
+
+// Send the commands of span SpanI and start its data transfer.
+// The commands wait on SSI0, the queue is not running.
+static void startspan(void){
+  spancommands(&Spans[SpanI], &lcdwait);
+  DC = DC_DATA;                         // whole span is data
+  DMA_StartTx8(DMA_CH_SSI0TX, &Screen[Spans[SpanI].Start],
+               &SSI0_DR_R, Spans[SpanI].Length);
+}
+
+// Priority 3 for the SSI0 interrupt, shared by the uDMA
+// path and the queue
+static void ssi0interrupt(void){
+                                        // priority 3, interrupt 7 is bits 31-29
+  NVIC_PRI1_R = (NVIC_PRI1_R&0x00FFFFFF)|0x60000000;
+  NVIC_EN0_R = 1<<SSI0_IRQ;             // enable interrupt 7 in NVIC
+}
+
+//********Nokia5110_InitDMA*****************
+// Set up uDMA channel 11 for SSI0 transmit and the SSI0
+// interrupt that chains the spans.  Call after Nokia5110_Init().
+// inputs: none
+// outputs: none
+void Nokia5110_InitDMA(void){
+  FlushActive = 0;
+  DMA_Init();
+  DMA_AssignChannel(DMA_CH_SSI0TX, 0);  // channel 11 encoding 0 is SSI0 TX
+  SSI0_DMACTL_R |= SSI_DMACTL_TXDMAE;   // SSI0 requests transmit DMA
+  ssi0interrupt();
+}
+
+//********Nokia5110_FlushDMA*****************
+// Start sending the changed parts of the framebuffer in the
+// background.  Returns right after the span scan.
+// inputs: done  function called from the SSI0 interrupt when
+//               the last span has been handed to SSI0, or 0
+// outputs: number of data bytes queued, 0 if nothing changed
+//          (done is then called right away)
+// assumes: Nokia5110_InitDMA() was called
+unsigned long Nokia5110_FlushDMA(void (*done)(void)){
+  unsigned long bytes;
+  lcdblock(&Nokia5110_FlushBusy);       // one flush at a time
+  lcdblock(&Nokia5110_QueueBusy);       // D/C may only change with SSI0 idle
+  bytes = findspans();
+  FlushDone = done;
+  if(NumSpans == 0){
+    if(done){
+      (*done)();
+    }
+    return 0;
+  }
+  SpanI = 0;
+  FlushActive = 1;
+  startspan();
+  return bytes;
+}
+
+//********Nokia5110_FlushBusy*****************
+// inputs: none
+// outputs: 1 while a DMA flush is still running
+int Nokia5110_FlushBusy(void){
+  return FlushActive;
+}
+
+//********Nokia5110_InitQueue*****************
+// Switch lcdwrite() to the interrupt-driven queue, all
+// functions that write to the LCD return without waiting on
+// SSI0 from now on.  Call after Nokia5110_Init().
+// inputs: none
+// outputs: none
+void Nokia5110_InitQueue(void){
+  lcdblock(&Nokia5110_FlushBusy);       // let a DMA flush finish
+                                        // and the last blocking byte go out
+  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  SSI0_IM_R = 0;
+  LcdQPut = LcdQGet = 0;
+  SSI0_CR1_R &= ~SSI_CR1_SSE;           // disable SSI
+  SSI0_CR1_R |= SSI_CR1_EOT;            // TX interrupt when the last bit is out
+  SSI0_CR1_R |= SSI_CR1_SSE;            // enable SSI
+  ssi0interrupt();
+  QueueOn = 1;
+}
+
+//********Nokia5110_QueueBusy*****************
+// inputs: none
+// outputs: 1 while queued bytes are waiting or being sent
+int Nokia5110_QueueBusy(void){
+  return (LcdQGet != LcdQPut) || (SSI0_IM_R&SSI_IM_TXIM);
+}
+
+// SSI0 interrupt, raised when a uDMA transfer to SSI0 completes
+// or, with the queue armed, when SSI0 has sent everything
+void SSI0_Handler(void){
+  if(DMA_Complete(DMA_CH_SSI0TX)){
+    SpanI = SpanI + 1;
+    if(SpanI < NumSpans){
+      startspan();                      // chain the next span
+    } else{
+      FlushActive = 0;
+      if(LcdQGet != LcdQPut){
+        SSI0_IM_R = SSI_IM_TXIM;        // queued while the flush ran
+      }
+      if(FlushDone){
+        (*FlushDone)();
+      }
+    }
+  }
+  if(SSI0_MIS_R&SSI_MIS_TXMIS){
+    lcdrefill();
+  }
+  if(LcdWaiting){                       // a thread waits in lcdblock()
+    LcdWaiting = 0;
+    OS_Signal(&LcdProgress);
+  }
+}
+
+//********Nokia5110_DisplayBuffer*****************
+// Send the whole framebuffer to the LCD, for example after
+// the direct functions have drawn over it.
+// inputs: none
+// outputs: none
+// assumes: LCD is in default horizontal addressing mode (V = 0)
+void Nokia5110_DisplayBuffer(void){
+  Nokia5110_DrawFullImage(Screen);
+  Nokia5110_ClearDirty();
+}
+
+//********Nokia5110_ClearDirty*****************
+// Forget all pending changes without sending them
+// inputs: none
+// outputs: none
+void Nokia5110_ClearDirty(void){
+  unsigned long y, i;
+  for(y=0; y<BANKS; y=y+1){
+    for(i=0; i<DIRTYWORDS; i=i+1){
+      Dirty[y][i] = 0;
+    }
+  }
+}
+
+//********Nokia5110_BufferDirty*****************
+// inputs: none
+// outputs: 1 if the framebuffer has changes not sent yet
+int Nokia5110_BufferDirty(void){
+  unsigned long y, i;
+  for(y=0; y<BANKS; y=y+1){
+    for(i=0; i<DIRTYWORDS; i=i+1){
+      if(Dirty[y][i]){
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
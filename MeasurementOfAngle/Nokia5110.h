@@ -63,12 +63,12 @@
 // commands to the PCD8544 driver.  One new feature of the
 // LM4F120 is that its SSIs can get their baud clock from
 // either the system clock or from the 16 MHz precision
-// internal oscillator.  If the system clock is faster than
-// 50 MHz, the SSI baud clock will be faster than the 4 MHz
-// maximum of the Nokia 5110.
+// internal oscillator.  The divisor is derived from Clock_Hz()
+// and follows clock changes, so the SSI clock stays under the
+// 4 MHz maximum of the Nokia 5110 at any bus clock.
 // inputs: none
 // outputs: none
-// assumes: system clock rate of 50 MHz or less
+// assumes: Clock_Init() or Clock_Set() has set the system clock
 void Nokia5110_Init(void);
 
 //********Nokia5110_OutChar*****************
@@ -79,7 +79,8 @@ void Nokia5110_Init(void);
 // One blank column of pixels will be printed on either side
 // of the character for readability.  Since characters are 8
 // pixels tall and 5 pixels wide, 12 characters fit per row,
-// and there are six rows.
+// and there are six rows.  Characters outside 0x20 to 0x7F
+// are printed as a blank.
 // inputs: data  character to print
 // outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
@@ -88,7 +89,9 @@ void Nokia5110_OutChar(unsigned char data);
 //********Nokia5110_OutString*****************
 // Print a string of characters to the Nokia 5110 48x84 LCD.
 // The string will automatically wrap, so padding spaces may
-// be needed to make the output look optimal.
+// be needed to make the output look optimal.  Up to a row of
+// 12 characters is rendered and sent as one burst.
+// Characters outside 0x20 to 0x7F are printed as a blank.
 // inputs: ptr  pointer to NULL-terminated ASCII string
 // outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
@@ -124,3 +127,213 @@ void Nokia5110_Clear(void);
 // outputs: none
 // assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_DrawFullImage(const char *ptr);
+
+//*************** RAM framebuffer *****************
+// The functions below draw into a 504-byte copy of the display
+// RAM and remember which bytes changed.  Nothing reaches the
+// LCD until Nokia5110_Flush(), which sends only the changed
+// spans.  Do not mix them with the direct functions above on
+// the same area of the screen.
+
+//********Nokia5110_ClearBuffer*****************
+// Clear the framebuffer.  The screen changes at the next
+// Nokia5110_Flush(), only columns that were not blank are sent.
+// inputs: none
+// outputs: none
+void Nokia5110_ClearBuffer(void);
+
+//********Nokia5110_BufferChar*****************
+// Draw a character into the framebuffer, 7 columns wide with
+// one blank column of padding on either side.
+// inputs: x     character column 0 to 11
+//         y     character row 0 to 5
+//         data  character to draw, 0x20 to 0x7F
+// outputs: none
+void Nokia5110_BufferChar(unsigned char x, unsigned char y, unsigned char data);
+
+//********Nokia5110_BufferString*****************
+// Draw a string into the framebuffer starting at a character
+// position.  The string wraps to the next row and back to the top.
+// inputs: x    character column 0 to 11
+//         y    character row 0 to 5
+//         ptr  pointer to NULL-terminated ASCII string
+// outputs: none
+void Nokia5110_BufferString(unsigned char x, unsigned char y, unsigned char *ptr);
+
+//********Nokia5110_Flush*****************
+// Send the changed parts of the framebuffer to the LCD with
+// the fewest cursor commands.  Spans of changed bytes that are
+// close together in a bank are merged.
+// inputs: none
+// outputs: number of data bytes sent
+// assumes: LCD is in default horizontal addressing mode (V = 0)
+unsigned long Nokia5110_Flush(void);
+
+//********Nokia5110_DisplayBuffer*****************
+// Send the whole framebuffer to the LCD, for example after
+// the direct functions have drawn over it.
+// inputs: none
+// outputs: none
+// assumes: LCD is in default horizontal addressing mode (V = 0)
+void Nokia5110_DisplayBuffer(void);
+
+//********Nokia5110_ClearDirty*****************
+// Forget all pending changes without sending them
+// inputs: none
+// outputs: none
+void Nokia5110_ClearDirty(void);
+
+//********Nokia5110_BufferDirty*****************
+// inputs: none
+// outputs: 1 if the framebuffer has changes not sent yet
+int Nokia5110_BufferDirty(void);
+
+//*************** uDMA transmit path *****************
+// Nokia5110_FlushDMA() sends the same spans as Nokia5110_Flush()
+// through uDMA channel 11 and returns at once, the main loop
+// keeps running during the screen update.  Do not call the
+// direct functions above while Nokia5110_FlushBusy() is 1.
+
+//********Nokia5110_InitDMA*****************
+// Set up uDMA channel 11 for SSI0 transmit and the SSI0
+// interrupt that chains the spans.  Call after Nokia5110_Init().
+// inputs: none
+// outputs: none
+void Nokia5110_InitDMA(void);
+
+//********Nokia5110_FlushDMA*****************
+// Start sending the changed parts of the framebuffer in the
+// background.  Returns right after the span scan.
+// inputs: done  function called from the SSI0 interrupt when
+//               the last span has been handed to SSI0, or 0
+// outputs: number of data bytes queued, 0 if nothing changed
+//          (done is then called right away)
+// assumes: Nokia5110_InitDMA() was called
+unsigned long Nokia5110_FlushDMA(void (*done)(void));
+
+//********Nokia5110_FlushBusy*****************
+// inputs: none
+// outputs: 1 while a DMA flush is still running
+int Nokia5110_FlushBusy(void);
+
+//*************** interrupt-driven queue *****************
+// A lighter alternative to uDMA.  After Nokia5110_InitQueue()
+// every function above that writes to the LCD puts its bytes
+// in a 512-entry RAM ring and returns, the SSI0 interrupt
+// sends them and sets the Data/Command pin at command/data
+// boundaries.  A caller only waits when the ring is full.
+// Nokia5110_FlushDMA() waits for the queue to empty first.
+
+//********Nokia5110_InitQueue*****************
+// Switch lcdwrite() to the interrupt-driven queue, all
+// functions that write to the LCD return without waiting on
+// SSI0 from now on.  Call after Nokia5110_Init().
+// inputs: none
+// outputs: none
+void Nokia5110_InitQueue(void);
+
+//********Nokia5110_QueueBusy*****************
+// inputs: none
+// outputs: 1 while queued bytes are waiting or being sent
+int Nokia5110_QueueBusy(void);
+
+//*************** graphics primitives *****************
+// Pixel graphics on the framebuffer, integer math only.  x is
+// the pixel column 0 to 83 (left to right), y the pixel row 0
+// to 47 (top to bottom).  Pixels off the screen are clipped.
+// color is 1 to set pixels (black) and 0 to clear them.
+// Like the text functions they change only the framebuffer,
+// Nokia5110_Flush() sends the result.
+
+//********Nokia5110_SetPxl*****************
+// Turn on one pixel in the framebuffer
+// inputs: x  column 0 to 83
+//         y  row 0 to 47
+// outputs: none
+void Nokia5110_SetPxl(long x, long y);
+
+//********Nokia5110_ClrPxl*****************
+// Turn off one pixel in the framebuffer
+// inputs: x  column 0 to 83
+//         y  row 0 to 47
+// outputs: none
+void Nokia5110_ClrPxl(long x, long y);
+
+//********Nokia5110_Line*****************
+// Draw a line with Bresenham's algorithm, adds and compares
+// only, both end points included.
+// inputs: x0,y0  start pixel
+//         x1,y1  end pixel
+//         color  1 to set, 0 to clear
+// outputs: none
+void Nokia5110_Line(long x0, long y0, long x1, long y1, int color);
+
+//********Nokia5110_FillRect*****************
+// Set or clear a rectangle of pixels
+// inputs: x,y    top left pixel
+//         w,h    width and height in pixels
+//         color  1 to set, 0 to clear
+// outputs: none
+void Nokia5110_FillRect(long x, long y, long w, long h, int color);
+
+//********Nokia5110_Sin*****************
+// Sine from a quarter-wave table, 1 deg resolution
+// inputs: deg  angle in degrees, any value
+// outputs: sin(deg) in 2.14 fixed point, -16384 to 16384
+long Nokia5110_Sin(long deg);
+
+//********Nokia5110_Cos*****************
+// Cosine from the same table, cos(deg) = sin(deg+90)
+// inputs: deg  angle in degrees, any value
+// outputs: cos(deg) in 2.14 fixed point, -16384 to 16384
+long Nokia5110_Cos(long deg);
+
+//********Nokia5110_Needle*****************
+// Draw a dial needle from the center out to radius r.  To
+// move it, erase the old needle (color 0) before drawing the
+// new one, they share the center pixel.
+// inputs: cx,cy  center pixel
+//         r      length in pixels
+//         deg    direction in degrees, 0 points right,
+//                90 points up (counterclockwise)
+//         color  1 to draw, 0 to erase
+// outputs: none
+void Nokia5110_Needle(long cx, long cy, long r, long deg, int color);
+
+//********Nokia5110_BarGauge*****************
+// Draw a horizontal bar gauge with a 1-pixel frame, filled
+// from the left in proportion to value/max
+// inputs: x,y    top left pixel of the frame
+//         w,h    size of the frame, at least 3x3
+//         value  0 to max, larger values show a full bar
+//         max    full scale, greater than 0
+// outputs: none
+void Nokia5110_BarGauge(long x, long y, long w, long h, unsigned long value, unsigned long max);
+
+//********Nokia5110_Sparkline*****************
+// Draw a line graph of recent samples into a rectangle,
+// oldest on the left, one column per sample.  The rectangle
+// is cleared first, so calling it with the history shifted by
+// one sample scrolls the graph.
+// inputs: x,y      top left pixel
+//         w,h      size in pixels, h at least 2
+//         samples  n values, oldest first
+//         n        number of samples, at most w are drawn
+//         min,max  values at the bottom and the top, min < max
+// outputs: none
+void Nokia5110_Sparkline(long x, long y, long w, long h, const unsigned short *samples,
+                         unsigned long n, unsigned short min, unsigned short max);
+
+//********Nokia5110_GraphicsBenchmark*****************
+// Time the primitives with the DWT cycle counter, at the
+// sizes the angle display uses.  The framebuffer is cleared
+// afterward.  Results can be inspected in the debugger watch
+// window.
+// inputs: none
+// outputs: none
+void Nokia5110_GraphicsBenchmark(void);
+
+extern unsigned long Nokia5110_LineCycles;   // full-screen diagonal, 84 pixels
+extern unsigned long Nokia5110_NeedleCycles; // needle, radius 22
+extern unsigned long Nokia5110_BarCycles;    // bar gauge 84x6
+extern unsigned long Nokia5110_SparkCycles;  // sparkline 36x30, 36 samples
@@ -0,0 +1,112 @@
+// Oversample.c
+// Runs on LM4F120/TM4C123
+// Oversampling pipeline for the angle sensor.  The ADC0
+// hardware averager (up to 64x) feeds a second-order CIC
+// decimator in fixed point, which trades sample rate for
+// resolution and removes most of the pot/ADC noise that
+// makes the displayed angle flicker.
+// Enes Kur
+// October 18, 2026
+
+// CIC (cascaded integrator-comb) decimator, order 2
+//   integrators at the input rate:   I1 += x,  I2 += I1
+//   every R inputs, combs:           C1 = I2 - I2old, y = C1 - C1old
+// The gain is R^2, so a 12-bit input needs 12 + 2*log2(R) bits,
+// 28 bits for R = 256.  The integrators are allowed to wrap,
+// modulo 2^32 arithmetic makes the comb outputs exact anyway.
+// The first two outputs after Oversample_Init() are the
+// filter filling up and read low.
+
+#include "Oversample.h"
+#include "ADC.h"
+
+static unsigned long Integ1, Integ2;	// integrator states
+static unsigned long Comb1, Comb2;		// comb delay elements
+static unsigned long Count;						// inputs since last output
+static unsigned long Ratio;						// decimation ratio R
+static unsigned long Log2R;
+static unsigned long HwLog2;					// hardware averaging 2^HwLog2
+
+//------------Oversample_Init------------
+// Set the ADC0 hardware averager and reset the CIC decimator.
+// Call after the ADC has been initialized.
+// Input: hwlog2  hardware averaging 2^hwlog2, 0 (off) to 6 (64x)
+//        r       CIC decimation ratio, power of 2 from 1 to 256,
+//                other values are rounded down to a power of 2
+// Output: none
+void Oversample_Init(unsigned long hwlog2, unsigned long r){
+	Oversample_SetAveraging(hwlog2);
+	if(r > 256){
+		r = 256;
+	}
+	Log2R = 0;
+	while((2UL<<Log2R) <= r){					// largest power of 2 not above r
+		Log2R++;
+	}
+	Ratio = 1<<Log2R;
+	Integ1 = Integ2 = 0;
+	Comb1 = Comb2 = 0;
+	Count = 0;
+}
+
+//------------Oversample_SetAveraging------------
+// Change the ADC0 hardware averager at run time and keep
+// Oversample_Latency() in step, the CIC state is kept
+// Input: hwlog2  hardware averaging 2^hwlog2, 0 (off) to 6 (64x)
+// Output: none
+void Oversample_SetAveraging(unsigned long hwlog2){
+	if(hwlog2 > 6){
+		hwlog2 = 6;
+	}
+	HwLog2 = hwlog2;
+	ADC0_SetAveraging(hwlog2);
+}
+
+//------------Oversample_Put------------
+// Feed one ADC sample into the decimator, runs in the sample ISR.
+// Costs about 10 cycles, 20 cycles when an output is produced.
+// Input: sample  12-bit ADC sample (already hardware averaged)
+//        out     where to store the decimated 12.4 result
+// Output: 1 if *out was written, 0 if more samples are needed
+int Oversample_Put(unsigned long sample, unsigned long *out){
+	unsigned long c1, y;
+	Integ1 = Integ1 + sample;
+	Integ2 = Integ2 + Integ1;
+	Count = Count + 1;
+	if(Count < Ratio){
+		return 0;
+	}
+	Count = 0;
+	c1 = Integ2 - Comb1;
+	Comb1 = Integ2;
+	y = c1 - Comb2;
+	Comb2 = c1;
+																			// y = sample*R^2, scale to 1/16 LSB
+	if(2*Log2R >= 4){
+		*out = y>>(2*Log2R-4);
+	} else{
+		*out = y<<(4-2*Log2R);
+	}
+	return 1;
+}
+
+//------------Oversample_OutputRate------------
+// Decimated output rate for a given ADC trigger rate
+// Input: inrate  ADC triggers per second
+// Output: outputs per second
+unsigned long Oversample_OutputRate(unsigned long inrate){
+	return inrate>>Log2R;
+}
+
+//------------Oversample_Latency------------
+// Latency added by the pipeline: the hardware averaging time
+// plus the CIC group delay of 2*(R-1)/2 input periods
+// Input: inrate  ADC triggers per second
+// Output: added latency in microseconds
+unsigned long Oversample_Latency(unsigned long inrate){
+	unsigned long hw, cic;
+																			// 2^HwLog2 conversions back to back
+	hw = (1000000UL<<HwLog2)/OVERSAMPLE_CONVRATE;
+	cic = ((Ratio-1)*1000000UL)/inrate;	// order 2: (R-1) input periods
+	return hw + cic;
+}
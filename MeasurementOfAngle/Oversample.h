@@ -0,0 +1,54 @@
+// Oversample.h
+// Runs on LM4F120/TM4C123
+// Oversampling pipeline for the angle sensor.  The ADC0
+// hardware averager (up to 64x) feeds a second-order CIC
+// decimator in fixed point, which trades sample rate for
+// resolution and removes most of the pot/ADC noise that
+// makes the displayed angle flicker.
+// Enes Kur
+// October 18, 2026
+
+// Output format: unsigned 12.4 fixed point, 0 to 65535
+// represents ADC codes 0 to 4095.9375 (1/16 LSB units).
+// Effective resolution: each 4x of averaging (hardware or CIC)
+// adds about one bit for white noise, so 64x hardware and R=16
+// give 12 + 3 + 2 = 17 bits before the 16-bit output rounding.
+
+#define OVERSAMPLE_CONVRATE 125000	// ADC0 conversions/second, set in ADC0_Init()
+
+//------------Oversample_Init------------
+// Set the ADC0 hardware averager and reset the CIC decimator.
+// Call after the ADC has been initialized.
+// Input: hwlog2  hardware averaging 2^hwlog2, 0 (off) to 6 (64x)
+//        r       CIC decimation ratio, power of 2 from 1 to 256,
+//                other values are rounded down to a power of 2
+// Output: none
+void Oversample_Init(unsigned long hwlog2, unsigned long r);
+
+//------------Oversample_SetAveraging------------
+// Change the ADC0 hardware averager at run time and keep
+// Oversample_Latency() in step, the CIC state is kept
+// Input: hwlog2  hardware averaging 2^hwlog2, 0 (off) to 6 (64x)
+// Output: none
+void Oversample_SetAveraging(unsigned long hwlog2);
+
+//------------Oversample_Put------------
+// Feed one ADC sample into the decimator, runs in the sample ISR.
+// Costs about 10 cycles, 20 cycles when an output is produced.
+// Input: sample  12-bit ADC sample (already hardware averaged)
+//        out     where to store the decimated 12.4 result
+// Output: 1 if *out was written, 0 if more samples are needed
+int Oversample_Put(unsigned long sample, unsigned long *out);
+
+//------------Oversample_OutputRate------------
+// Decimated output rate for a given ADC trigger rate
+// Input: inrate  ADC triggers per second
+// Output: outputs per second
+unsigned long Oversample_OutputRate(unsigned long inrate);
+
+//------------Oversample_Latency------------
+// Latency added by the pipeline: the hardware averaging time
+// plus the CIC group delay of 2*(R-1)/2 input periods
+// Input: inrate  ADC triggers per second
+// Output: added latency in microseconds
+unsigned long Oversample_Latency(unsigned long inrate);
@@ -0,0 +1,89 @@
+// Rate.c
+// Runs on LM4F120/TM4C123
+// Adaptive sample rate for the angle sensor.  The ADC is
+// triggered fast while the pot is moving, for short tracking
+// latency, and slow while it is still, which cuts the ADC,
+// interrupt and display work when nothing is happening.
+// Enes Kur
+// October 18, 2026
+
+#include "Rate.h"
+#include "Oversample.h"
+
+static void (*SetPeriod)(unsigned long period);
+static unsigned long SlowLog2;			// hardware averaging while slow
+static unsigned long Ref;						// sample at the last motion
+static unsigned long Quiet;					// samples since the last motion
+static int Fast;										// 1 while sampling fast
+
+unsigned long Rate_Changes;
+
+// Switch between the two rates
+static void setfast(int fast){
+	Fast = fast;
+	if(fast){
+		Oversample_SetAveraging(RATE_FAST_AVERAGE);	// Oversample_Latency() follows
+		(*SetPeriod)(RATE_FAST_PERIOD);
+	} else{
+		Oversample_SetAveraging(SlowLog2);
+		(*SetPeriod)(RATE_SLOW_PERIOD);
+	}
+	Rate_Changes++;
+}
+
+//------------Rate_Init------------
+// Start in the fast state and reset the activity detector
+// Input: setperiod  function that changes the trigger interval,
+//                   ADC0_SetTriggerPeriod or SysTick_SetPeriod
+//        slowlog2   hardware averaging 2^slowlog2 while slow
+// Output: none
+void Rate_Init(void(*setperiod)(unsigned long period), unsigned long slowlog2){
+	SetPeriod = setperiod;
+	SlowLog2 = slowlog2;
+	Ref = 0;
+	Quiet = 0;
+	setfast(1);
+	Rate_Changes = 0;
+}
+
+//------------Rate_Put------------
+// Check one raw sample for motion and change the sample rate
+// if needed, runs in the sample ISR.  About 15 cycles, plus a
+// register write or two when the rate changes.
+// Input: sample  12-bit ADC sample
+// Output: 1 if the rate was changed by this sample
+int Rate_Put(unsigned long sample){
+	unsigned long diff;
+	diff = (sample > Ref) ? (sample - Ref) : (Ref - sample);
+	if(diff > RATE_WAKE){
+		Ref = sample;										// moving, follow it
+		Quiet = 0;
+		if(!Fast){
+			setfast(1);
+			return 1;
+		}
+		return 0;
+	}
+	if(Fast){
+		Quiet = Quiet + 1;
+		if(Quiet >= RATE_IDLE){
+			setfast(0);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//------------Rate_Fast------------
+// Input: none
+// Output: 1 while sampling fast, 0 while slow
+int Rate_Fast(void){
+	return Fast;
+}
+
+//------------Rate_Hz------------
+// Input: none
+// Output: current sample rate in samples per second
+unsigned long Rate_Hz(void){
+	return Fast ? RATE_FAST_HZ : RATE_SLOW_HZ;
+}
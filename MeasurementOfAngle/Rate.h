@@ -0,0 +1,55 @@
+// Rate.h
+// Runs on LM4F120/TM4C123
+// Adaptive sample rate for the angle sensor.  The ADC is
+// triggered fast while the pot is moving, for short tracking
+// latency, and slow while it is still, which cuts the ADC,
+// interrupt and display work when nothing is happening.
+// Enes Kur
+// October 18, 2026
+
+// Going fast is immediate, the first raw sample that is more
+// than RATE_WAKE LSB away from the reference switches.  Going
+// slow needs RATE_IDLE quiet samples in a row (1 s), so a pot
+// turned in small steps does not toggle the rate.
+// While fast the hardware averager drops to 16x, a two channel
+// scan of 2*16 conversions (256 us) then fits the 1 ms period,
+// 64x would take 1.02 ms.  Resolution matters when still,
+// latency when moving.
+// The decimator runs at a fixed ratio, so the display rate
+// follows: 1 kHz/16 = 62.5 Hz moving, 125 Hz/16 = 7.8 Hz still.
+
+#define RATE_FAST_PERIOD 80000		// 1 ms in 12.5 ns bus cycles, 1 kHz triggers
+#define RATE_FAST_AVERAGE 4				// 16x hardware averaging while fast
+#define RATE_SLOW_PERIOD 640000		// 8 ms, 125 Hz triggers
+#define RATE_FAST_HZ (80000000/RATE_FAST_PERIOD)
+#define RATE_SLOW_HZ (80000000/RATE_SLOW_PERIOD)
+#define RATE_WAKE 6								// ADC LSB, about 0.4 deg
+#define RATE_IDLE 1000						// fast samples without motion before slowing down
+
+//------------Rate_Init------------
+// Start in the fast state and reset the activity detector
+// Input: setperiod  function that changes the trigger interval,
+//                   ADC0_SetTriggerPeriod or SysTick_SetPeriod
+//        slowlog2   hardware averaging 2^slowlog2 while slow
+// Output: none
+void Rate_Init(void(*setperiod)(unsigned long period), unsigned long slowlog2);
+
+//------------Rate_Put------------
+// Check one raw sample for motion and change the sample rate
+// if needed, runs in the sample ISR.  About 15 cycles, plus a
+// register write or two when the rate changes.
+// Input: sample  12-bit ADC sample
+// Output: 1 if the rate was changed by this sample
+int Rate_Put(unsigned long sample);
+
+//------------Rate_Fast------------
+// Input: none
+// Output: 1 while sampling fast, 0 while slow
+int Rate_Fast(void);
+
+//------------Rate_Hz------------
+// Input: none
+// Output: current sample rate in samples per second
+unsigned long Rate_Hz(void);
+
+extern unsigned long Rate_Changes;		// number of rate switches since Rate_Init
@@ -0,0 +1,187 @@
+// Telemetry.c
+// Runs on LM4F120/TM4C123
+// Binary sample stream on UART0 (PA1-0, the LaunchPad virtual
+// COM port) at 1,000,000 baud.  Records are packed into framed
+// packets with a sequence number and a CRC-16 and sent by
+// uDMA channel 9, the CPU only copies each record into a buffer.
+// Enes Kur
+// October 18, 2026
+
+// A 1 Mbaud link carries 100,000 bytes/s, a packet of 32 one-word
+// records is 72 bytes, so up to 44,000 samples/s can be streamed.
+// The CRC is updated as bytes are stored, about 20 cycles per
+// byte, so a one-word record costs roughly 80 cycles in the ISR.
+
+#include "Telemetry.h"
+#include "uDMA.h"
+#include "..//tm4c123gh6pm.h"
+#include "..//Common/Clock.h"
+
+long StartCritical(void);    // previous I bit, disable interrupts
+void EndCritical(long sr);   // restore I bit to previous value
+
+#define HEADER 6							// sync, sync, seq, seq, words, records
+#define FRAMEMAX (HEADER+2*TELEM_PAYLOAD+2)
+#define PACKETMASK (TELEM_PACKETS-1)
+
+struct Packet{
+	char Bytes[FRAMEMAX];
+	unsigned long Length;				// bytes to send
+};
+static struct Packet Packets[TELEM_PACKETS];
+static unsigned long PutI;			// packets queued, slot PutI is being filled
+static unsigned long GetI;			// packets sent, slot GetI is being sent
+static int Sending;							// 1 while uDMA channel 9 runs
+static unsigned long Fill;			// bytes in the packet being filled
+static unsigned long Records;		// records in the packet being filled
+static unsigned long Words;			// words per record
+static unsigned long PerPacket;	// records per packet
+static unsigned short Crc;			// CRC of the packet being filled
+static unsigned short Seq;			// sequence number of the packet being filled
+unsigned long Telemetry_Dropped;
+
+// CRC-16/CCITT of one nibble, polynomial 0x1021
+static const unsigned short CrcTable[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// Store a byte in the packet being filled and add it to the CRC
+static void putbyte(char *p, unsigned char data){
+	p[Fill] = data;
+	Fill = Fill + 1;
+	Crc = (Crc<<4)^CrcTable[(Crc>>12)^(data>>4)];
+	Crc = (Crc<<4)^CrcTable[(Crc>>12)^(data&0x0F)];
+}
+
+// Send the oldest queued packet if the channel is free
+static void startsend(void){
+	if(!Sending && (GetI != PutI)){
+		Sending = 1;
+		DMA_StartTx8(DMA_CH_UART0TX, Packets[GetI&PACKETMASK].Bytes,
+		             &UART0_DR_R, Packets[GetI&PACKETMASK].Length);
+	}
+}
+
+// Set the divisor for 1,000,000 baud, 64 times BRD = 4*hz/baud,
+// IBRD is the integer part and FBRD the 6 fraction bits.
+// 5+0/64 at 80 MHz, 1+0/64 at 16 MHz.
+static void setbaud(unsigned long hz){
+	unsigned long div;
+	div = (hz*4 + 500000)/1000000;
+	UART0_IBRD_R = div>>6;
+	UART0_FBRD_R = div&0x3F;
+																				// 8 bit word length (no parity bits, one stop bit, FIFOs)
+	UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN);	// also latches IBRD, FBRD
+}
+
+// Keep the baud rate across a clock change, a packet being
+// sent during the change may be lost to the CRC check
+static void rebaud(unsigned long hz, unsigned long oldhz){
+	UART0_CTL_R &= ~UART_CTL_UARTEN;
+	setbaud(hz);
+	UART0_CTL_R |= UART_CTL_UARTEN;
+}
+
+//------------Telemetry_Init------------
+// Initialize UART0 for 1,000,000 baud (any bus clock of 16 MHz or more),
+// 8 bit word length, no parity bits, one stop bit, FIFOs
+// enabled, transmit by uDMA channel 9, and the UART0
+// interrupt that chains the packets.
+// Input: words  16-bit words per record, 1 to TELEM_MAXWORDS
+// Output: none
+void Telemetry_Init(unsigned long words){ volatile unsigned long delay;
+	if(words < 1) words = 1;
+	if(words > TELEM_MAXWORDS) words = TELEM_MAXWORDS;
+	Words = words;
+	PerPacket = TELEM_PAYLOAD/words;
+	PutI = GetI = 0;
+	Sending = 0;
+	Fill = 0;
+	Records = 0;
+	Seq = 0;
+	Telemetry_Dropped = 0;
+	SYSCTL_RCGC1_R |= SYSCTL_RCGC1_UART0; // activate UART0
+	SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOA; // activate port A
+	delay = SYSCTL_RCGC2_R;								// for clock to be stable
+	UART0_CTL_R &= ~UART_CTL_UARTEN;      // disable UART
+	setbaud(Clock_Hz());									// IBRD = int(80,000,000 / (16 * 1,000,000)) = 5
+	Clock_AddListener(&rebaud);
+	UART0_DMACTL_R = UART_DMACTL_TXDMAE;	// UART0 requests transmit DMA
+	UART0_CTL_R |= UART_CTL_UARTEN;       // enable UART
+	GPIO_PORTA_AFSEL_R |= 0x03;           // enable alt funct on PA1-0
+	GPIO_PORTA_DEN_R |= 0x03;             // enable digital I/O on PA1-0
+																				// configure PA1-0 as UART
+	GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFFFFFF00)+0x00000011;
+	GPIO_PORTA_AMSEL_R &= ~0x03;          // disable analog functionality on PA
+	DMA_Init();
+	DMA_AssignChannel(DMA_CH_UART0TX, 0);	// channel 9 encoding 0 is UART0 TX
+																				// priority 3, interrupt 5 is bits 15-13
+	NVIC_PRI1_R = (NVIC_PRI1_R&0xFFFF00FF)|0x00006000;
+	NVIC_EN0_R = 1<<5;										// enable interrupt 5 in NVIC
+}
+
+//------------Telemetry_Put------------
+// Append one record to the packet being filled.  A full packet
+// is queued and sent in the background.  Safe to call from any
+// interrupt, it runs a short critical section.
+// Input: record  words 16-bit values
+// Output: none
+void Telemetry_Put(const unsigned short *record){
+	char *p;
+	unsigned long i;
+	long sr;
+	sr = StartCritical();
+	p = Packets[PutI&PACKETMASK].Bytes;
+	if(Fill == 0){									// new packet, the sync bytes are not in the CRC
+		p[0] = TELEM_SYNC0;
+		p[1] = TELEM_SYNC1;
+		Fill = 2;
+		Crc = 0xFFFF;
+		putbyte(p, Seq&0xFF);
+		putbyte(p, Seq>>8);
+		putbyte(p, Words);
+		putbyte(p, PerPacket);
+	}
+	for(i=0; i<Words; i++){
+		putbyte(p, record[i]&0xFF);
+		putbyte(p, record[i]>>8);
+	}
+	Records = Records + 1;
+	if(Records == PerPacket){
+		p[Fill] = Crc&0xFF;						// CRC goes out low byte first
+		p[Fill+1] = Crc>>8;
+		Packets[PutI&PACKETMASK].Length = Fill + 2;
+		Seq = Seq + 1;								// a dropped packet leaves a gap
+		if((PutI - GetI) < (TELEM_PACKETS-1)){
+			PutI = PutI + 1;						// queue it, the next slot is free
+			startsend();
+		} else{
+			Telemetry_Dropped++;				// all other buffers wait for UART0, refill this one
+		}
+		Fill = 0;
+		Records = 0;
+	}
+	EndCritical(sr);
+}
+
+//------------Telemetry_Busy------------
+// Input: none
+// Output: 1 while a queued packet is not fully on the wire,
+//         uDMA running or the UART still shifting, so the bus
+//         clock must not change
+int Telemetry_Busy(void){
+	return Sending || (GetI != PutI) || (UART0_FR_R&UART_FR_BUSY);
+}
+
+// UART0 interrupt, raised when a uDMA transfer to UART0 completes
+void UART0_Handler(void){
+	long sr;
+	if(DMA_Complete(DMA_CH_UART0TX)){
+		sr = StartCritical();
+		GetI = GetI + 1;
+		Sending = 0;
+		startsend();									// chain the next packet
+		EndCritical(sr);
+	}
+}
@@ -0,0 +1,55 @@
+// Telemetry.h
+// Runs on LM4F120/TM4C123
+// Binary sample stream on UART0 (PA1-0, the LaunchPad virtual
+// COM port) at 1,000,000 baud.  Records are packed into framed
+// packets with a sequence number and a CRC-16 and sent by
+// uDMA channel 9, the CPU only copies each record into a buffer.
+// Enes Kur
+// October 18, 2026
+
+// Packet, little-endian, 6 + 2*words*records + 2 bytes
+// [0]  0xA5         sync
+// [1]  0x5A         sync
+// [2]  seq low      packet counter, wraps at 65536
+// [3]  seq high
+// [4]  words        16-bit words per record, 1 to 8
+// [5]  records      records in this packet
+// [6]  data         records*words 16-bit words
+// [..] CRC low      CRC-16/CCITT (poly 0x1021, init 0xFFFF)
+// [..] CRC high     over bytes 2 up to the end of the data
+// A packet that cannot be queued because all buffers are still
+// waiting to be sent is dropped, its sequence number is not
+// reused, so the receiver sees the gap.
+// Host/TelemetryDecode.c turns a capture into CSV.
+
+#define TELEM_SYNC0 0xA5
+#define TELEM_SYNC1 0x5A
+#define TELEM_MAXWORDS 8			// words per record
+#define TELEM_PAYLOAD 32			// data words per packet
+#define TELEM_PACKETS 4				// packet buffers, power of 2
+
+extern unsigned long Telemetry_Dropped;	// packets lost because no buffer was free
+
+//------------Telemetry_Init------------
+// Initialize UART0 for 1,000,000 baud (any bus clock of 16 MHz or more),
+// 8 bit word length, no parity bits, one stop bit, FIFOs
+// enabled, transmit by uDMA channel 9, and the UART0
+// interrupt that chains the packets.
+// Input: words  16-bit words per record, 1 to TELEM_MAXWORDS
+// Output: none
+void Telemetry_Init(unsigned long words);
+
+//------------Telemetry_Put------------
+// Append one record to the packet being filled.  A full packet
+// is queued and sent in the background.  Safe to call from any
+// interrupt, it runs a short critical section.
+// Input: record  words 16-bit values
+// Output: none
+void Telemetry_Put(const unsigned short *record);
+
+//------------Telemetry_Busy------------
+// Input: none
+// Output: 1 while a queued packet is not fully on the wire,
+//         uDMA running or the UART still shifting, so the bus
+//         clock must not change
+int Telemetry_Busy(void);
@@ -0,0 +1,89 @@
+// uDMA.c
+// Runs on LM4F120/TM4C123
+// Minimal driver for the micro direct memory access controller.
+// Peripheral transmit channels in basic mode, 8-bit elements,
+// memory to a fixed peripheral data register.
+// Enes Kur
+// October 18, 2026
+
+#include "uDMA.h"
+#include "..//tm4c123gh6pm.h"
+
+// The control table holds 4 words per channel, primary
+// structures for channels 0-31 then alternate structures.
+// The controller requires it to be 1024-byte aligned.
+static unsigned long ControlTable[256] __attribute__((aligned(1024)));
+
+//------------DMA_Init------------
+// Activate the uDMA controller and point it at the channel
+// control table.  Safe to call more than once.
+// Input: none
+// Output: none
+void DMA_Init(void){ volatile unsigned long delay;
+	SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;	// activate uDMA
+	delay = SYSCTL_RCGCDMA_R;							// for clock to be stable
+	UDMA_CFG_R = UDMA_CFG_MASTEN;					// enable controller
+	UDMA_CTLBASE_R = (unsigned long)ControlTable;
+}
+
+//------------DMA_AssignChannel------------
+// Select which peripheral drives a channel (DMACHMAPn)
+// Input: channel   0 to 31
+//        encoding  0 to 4, see the channel assignment table
+// Output: none
+void DMA_AssignChannel(unsigned long channel, unsigned long encoding){
+	volatile unsigned long *map;
+	unsigned long shift;
+	map = &UDMA_CHMAP0_R + (channel>>3);	// 8 channels per map register
+	shift = (channel&0x07)*4;
+	*map = (*map&~(0x0F<<shift))|(encoding<<shift);
+	UDMA_PRIOCLR_R = 1<<channel;					// default priority
+	UDMA_ALTCLR_R = 1<<channel;						// use primary control structure
+	UDMA_USEBURSTCLR_R = 1<<channel;			// respond to single and burst requests
+	UDMA_REQMASKCLR_R = 1<<channel;				// allow the peripheral to request
+}
+
+//------------DMA_StartTx8------------
+// Start a memory to peripheral transfer of bytes.  The source
+// address increments, the destination stays fixed, and the
+// peripheral's requests pace the transfer 4 bytes per burst.
+// Completion raises the peripheral's own interrupt vector,
+// check it there with DMA_Complete().
+// Input: channel  0 to 31
+//        source   first byte to send
+//        dest     peripheral data register
+//        count    1 to 1024 bytes
+// Output: none
+void DMA_StartTx8(unsigned long channel, const char *source,
+                  volatile unsigned long *dest, unsigned long count){
+	unsigned long *entry;
+	entry = &ControlTable[channel*4];
+	entry[0] = (unsigned long)(source+count-1);	// source end pointer
+	entry[1] = (unsigned long)dest;								// destination end pointer
+	entry[2] = UDMA_CHCTL_DSTINC_NONE|UDMA_CHCTL_DSTSIZE_8|
+	           UDMA_CHCTL_SRCINC_8|UDMA_CHCTL_SRCSIZE_8|
+	           UDMA_CHCTL_ARBSIZE_4|
+	           ((count-1)<<UDMA_CHCTL_XFERSIZE_S)|
+	           UDMA_CHCTL_XFERMODE_BASIC;
+	UDMA_ENASET_R = 1<<channel;					// go, cleared by hardware when done
+}
+
+//------------DMA_Busy------------
+// Input: channel  0 to 31
+// Output: 1 while the channel is still enabled (transfer running)
+int DMA_Busy(unsigned long channel){
+	return (UDMA_ENASET_R>>channel)&1;
+}
+
+//------------DMA_Complete------------
+// Check and acknowledge the completion flag of a channel,
+// call from the peripheral's interrupt handler
+// Input: channel  0 to 31
+// Output: 1 if the channel finished since the last call
+int DMA_Complete(unsigned long channel){
+	if(UDMA_CHIS_R&(1<<channel)){
+		UDMA_CHIS_R = 1<<channel;						// write one to clear
+		return 1;
+	}
+	return 0;
+}
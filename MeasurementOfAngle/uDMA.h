@@ -0,0 +1,51 @@
+// uDMA.h
+// Runs on LM4F120/TM4C123
+// Minimal driver for the micro direct memory access controller.
+// Peripheral transmit channels in basic mode, 8-bit elements,
+// memory to a fixed peripheral data register.
+// Enes Kur
+// October 18, 2026
+
+// Channels used in this project
+#define DMA_CH_UART0TX 9					// encoding 0
+#define DMA_CH_SSI0TX  11					// encoding 0
+
+//------------DMA_Init------------
+// Activate the uDMA controller and point it at the channel
+// control table.  Safe to call more than once.
+// Input: none
+// Output: none
+void DMA_Init(void);
+
+//------------DMA_AssignChannel------------
+// Select which peripheral drives a channel (DMACHMAPn)
+// Input: channel   0 to 31
+//        encoding  0 to 4, see the channel assignment table
+// Output: none
+void DMA_AssignChannel(unsigned long channel, unsigned long encoding);
+
+//------------DMA_StartTx8------------
+// Start a memory to peripheral transfer of bytes.  The source
+// address increments, the destination stays fixed, and the
+// peripheral's requests pace the transfer 4 bytes per burst.
+// Completion raises the peripheral's own interrupt vector,
+// check it there with DMA_Complete().
+// Input: channel  0 to 31
+//        source   first byte to send
+//        dest     peripheral data register
+//        count    1 to 1024 bytes
+// Output: none
+void DMA_StartTx8(unsigned long channel, const char *source,
+                  volatile unsigned long *dest, unsigned long count);
+
+//------------DMA_Busy------------
+// Input: channel  0 to 31
+// Output: 1 while the channel is still enabled (transfer running)
+int DMA_Busy(unsigned long channel);
+
+//------------DMA_Complete------------
+// Check and acknowledge the completion flag of a channel,
+// call from the peripheral's interrupt handler
+// Input: channel  0 to 31
+// Output: 1 if the channel finished since the last call
+int DMA_Complete(unsigned long channel);
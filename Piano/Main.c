@@ -1,6 +1,10 @@
 // Main.c
 // Runs on LM4F120 or TM4C123
 // Uses SysTick interrupts to implement a 4-key digital piano
+// The key scanner and the sound engine are active objects
+// (Common/AO.h): a key edge interrupt posts to the scanner,
+// the scanner posts the note to the sound engine, and the CPU
+// sleeps while nothing happens.
 // Enes Kur
 // July 3, 2022
 // Port B bits 3-0 have the 4-bit DAC
@@ -9,6 +13,8 @@
 #include "..//tm4c123gh6pm.h"
 #include "Sound.h"
 #include "Piano.h"
+#include "..//Common/Clock.h"
+#include "..//Common/AO.h"
 
 /* This example accompanies the book
    "Embedded Systems: Introduction to ARM Cortex M Microcontrollers",
@@ -31,74 +37,70 @@ Piano key 0: C generates a sinusoidal DACOUT at 523.251 Hz : 4778
 void DisableInterrupts(void); // Disable interrupts
 void EnableInterrupts(void);  // Enable interrupts
 
-void delay(unsigned long msec);
-void PLL_Init(void);
+#define SIG_KEYS 1	// to Keys, a key went up or down
+#define SIG_TONE 2	// to Sound, Data is the SysTick period, 0 for silence
+
+struct AO_Object Keys;	// key scanner
+struct AO_Object Sound;	// sound engine
+struct AO_Event *KeysQueue[8];	// a bouncing key edge comes in bursts
+struct AO_Event *SoundQueue[4];
+
+void KeysChanged(unsigned long keys);
+void Keys_Dispatch(const struct AO_Event *e);
+void Sound_Dispatch(const struct AO_Event *e);
 
 int main(void){ 
-	unsigned char input;
 // PortE used for piano keys, PortB used for DAC
-	PLL_Init();		// 80 MHz clock
+	Clock_Init();	// 80 MHz clock
   Sound_Init(); // initialize SysTick timer and DAC
   Piano_Init();	// Port E init
-  EnableInterrupts();  // enable after all initialization are done
-  while(1){                
-// input from keys to select tone
-// tone goes to SysTick 
-		input = Piano_In();
-		switch (input){
-			case 1:			// key 0 pressed, note C playing
-				Sound_Tone(4778);
-				break;
-			case 2:			// key 1 pressed, note D playing
-				Sound_Tone(4256);
-				break;
-			case 4:			// key 2 pressed, note E playing
-				Sound_Tone(3792);
-				break;
-			case 8:			// key 3 pressed, note G playing
-				Sound_Tone(3188);
-				break;
-			case 0:			// no key pressed
-				Sound_Off();
-				break;
-			default:		// default
-				Sound_Off();
-				break;
-		}
-		delay(5);
-	}
+	AO_Init();
+	AO_Start(&Sound, &Sound_Dispatch, SoundQueue, 4);	// highest priority
+	AO_Start(&Keys, &Keys_Dispatch, KeysQueue, 8);
+	Piano_InitEdges(&KeysChanged);	// Port E interrupt on both edges
+	AO_Post(&Keys, SIG_KEYS, 0);	// pick up a key held at reset
+  AO_Run();  // enables interrupts, never returns
 }
 
-// Inputs: Number of msec to delay
-// Outputs: None
-void delay(unsigned long msec){ 
-  unsigned long count;
-  while(msec > 0 ) {  // repeat while there are still delay
-    count = 16000;    // about 1ms
-    while (count > 0) { 
-      count--;
-    } // This while loop takes approximately 3 cycles
-    msec--;
-  }
+// Called from GPIOPortE_Handler on a key edge
+void KeysChanged(unsigned long keys){
+	AO_Post(&Keys, SIG_KEYS, keys);
 }
 
-void PLL_Init(void){
-  // 0) Use RCC2
-  SYSCTL_RCC2_R |=  0x80000000;  // USERCC2
-  // 1) bypass PLL while initializing
-  SYSCTL_RCC2_R |=  0x00000800;  // BYPASS2, PLL bypass
-  // 2) select the crystal value and oscillator source
-  SYSCTL_RCC_R = (SYSCTL_RCC_R &~0x000007C0)   // clear XTAL field, bits 10-6
-                 + 0x00000540;   // 10101, configure for 16 MHz crystal
-  SYSCTL_RCC2_R &= ~0x00000070;  // configure for main oscillator source
-  // 3) activate PLL by clearing PWRDN
-  SYSCTL_RCC2_R &= ~0x00002000;
-  // 4) set the desired system divider
-  SYSCTL_RCC2_R |= 0x40000000;   // use 400 MHz PLL
-  SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~ 0x1FC00000)  // clear system clock divider
-                  + (4<<22);      // configure for 80 MHz clock ( writes on SYSDIV2 feild )
-  // 5) wait for the PLL to lock by polling PLLLRIS
-  while((SYSCTL_RIS_R&0x00000040)==0){};  // wait for PLLRIS bit
-  // 6) enable use of PLL by clearing BYPASS
-  SYSCTL_RCC2_R &= ~0x00000800;
+// Key scanner
+// input from keys to select tone
+// tone goes to the sound engine
+void Keys_Dispatch(const struct AO_Event *e){
+	unsigned long input;
+	input = Piano_In();	// now, a later edge may have been dropped
+	switch (input){
+		case 1:			// key 0 pressed, note C playing
+			AO_Post(&Sound, SIG_TONE, 4778);
+			break;
+		case 2:			// key 1 pressed, note D playing
+			AO_Post(&Sound, SIG_TONE, 4256);
+			break;
+		case 4:			// key 2 pressed, note E playing
+			AO_Post(&Sound, SIG_TONE, 3792);
+			break;
+		case 8:			// key 3 pressed, note G playing
+			AO_Post(&Sound, SIG_TONE, 3188);
+			break;
+		case 0:			// no key pressed
+			AO_Post(&Sound, SIG_TONE, 0);
+			break;
+		default:		// default
+			AO_Post(&Sound, SIG_TONE, 0);
+			break;
+	}
+}
+
+// Sound engine
+// tone goes to SysTick
+void Sound_Dispatch(const struct AO_Event *e){
+	if(e->Data){
+		Sound_Tone(e->Data);
+	} else{
+		Sound_Off();
+	}
 }
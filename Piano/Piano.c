@@ -9,6 +9,8 @@
 #include "Piano.h"
 #include "..//tm4c123gh6pm.h"
 
+void (*PianoTask)(unsigned long keys);	// user function called on each key change
+
 // **************Piano_Init*********************
 // Initialize piano key inputs
 // Input: none
@@ -34,3 +36,26 @@ void Piano_Init(void){ unsigned long delay;
 unsigned long Piano_In(void){
   return GPIO_PORTE_DATA_R & 0x0F;
 }
+
+// **************Piano_InitEdges*********************
+// Interrupt on every press and release of a piano key,
+// call after Piano_Init()
+// Input: task  called from GPIOPortE_Handler with Piano_In()
+// Output: none
+void Piano_InitEdges(void(*task)(unsigned long keys)){
+	PianoTask = task;
+	GPIO_PORTE_IS_R &= ~0x0F;					// edge-sensitive
+	GPIO_PORTE_IBE_R |= 0x0F;					// both edges
+	GPIO_PORTE_ICR_R = 0x0F;					// clear stale flags
+	GPIO_PORTE_IM_R |= 0x0F;					// arm PE0-3
+																		// priority 3, interrupt 4 is bits 7-5
+	NVIC_PRI1_R = (NVIC_PRI1_R&0xFFFFFF00)|0x00000060;
+	NVIC_EN0_R = 1<<4;								// enable interrupt 4 in NVIC
+}
+
+// Any key edge, bounces included, the task gets the keys as
+// they are now
+void GPIOPortE_Handler(void){
+	GPIO_PORTE_ICR_R = 0x0F;					// acknowledge PE0-3
+	(*PianoTask)(Piano_In());
+}
@@ -19,3 +19,10 @@ void Piano_Init(void);
 // 0x01 is key 0 pressed, 0x02 is key 1 pressed,
 // 0x04 is key 2 pressed, 0x08 is key 3 pressed
 unsigned long Piano_In(void);
+
+// **************Piano_InitEdges*********************
+// Interrupt on every press and release of a piano key,
+// call after Piano_Init()
+// Input: task  called from GPIOPortE_Handler with Piano_In()
+// Output: none
+void Piano_InitEdges(void(*task)(unsigned long keys));
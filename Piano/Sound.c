@@ -8,6 +8,7 @@
 #include "Sound.h"
 #include "DAC.h"
 #include "..//tm4c123gh6pm.h"
+#include "..//Common/Clock.h"
 
 const unsigned char SineWave[32] = {8,9,11,12,13,14,14,15,15,15,14,14,13,12,11,9,8,7,5,4,3,2,2,1,1,1,2,2,3,4,5,7};
 unsigned char Index;
@@ -22,7 +23,7 @@ void Sound_Init(void){
 	Index = 0;
   DAC_Init();										// Port B init
 	NVIC_ST_CTRL_R = 0;						// Disable SysTick before init
-	NVIC_ST_RELOAD_R = 90908; 		// For init, changes with every button press
+	NVIC_ST_RELOAD_R = Clock_Scale(90909)-1;	// For init, changes with every button press
 																// priority: 0
 	NVIC_SYS_PRI3_R = NVIC_SYS_PRI3_R & 0x00FFFFFF;
 	NVIC_ST_CTRL_R = 0x00000007;	// Enable SysTick with interrupt
@@ -37,7 +38,7 @@ void Sound_Init(void){
 // Output: none
 void Sound_Tone(unsigned long period){
 // this routine sets the RELOAD and starts SysTick
-	NVIC_ST_RELOAD_R = period - 1;
+	NVIC_ST_RELOAD_R = Clock_Scale(period) - 1;	// 12.5 ns units at any bus clock
 }
 
 
@@ -0,0 +1,181 @@
+// EventLog.c
+// Runs on LM4F120/TM4C123
+// Timestamped state-transition log for the traffic light FSM.
+// The FSM is the single producer, it drops compact binary
+// events into a lock-free ring buffer.  The lowest priority
+// UART0 interrupt is the single consumer, it drains the
+// ring over UART0 in the background.
+// Enes Kur
+// October 18, 2026
+
+// Only the producer writes PutI and only the consumer writes
+// GetI.  Both are 32-bit and are read and written with
+// single instructions, so no critical section is needed.
+// The producer kicks the consumer through the NVIC software
+// trigger register, so recording an event never touches
+// the UART itself.
+// Text has its own ring with the same single producer, single
+// consumer rule.  The handler is the only writer of UART0, it
+// picks a frame or a whole text line at a time, so a CSV line
+// is never cut by a frame or a frame by text.  The host
+// decoder skips the text through the sync byte and checksum.
+
+#include "EventLog.h"
+#include "..//tm4c123gh6pm.h"
+
+#define EVENTLOG_MASK (EVENTLOG_SIZE-1)
+#define TEXT_MASK (EVENTLOG_TEXTSIZE-1)
+#define UART0_IRQ 5									// UART0 interrupt number
+
+struct Event{
+	unsigned long Time;								// Timer1A count when recorded
+	unsigned long Info;								// old<<12, new<<8, input
+};
+typedef struct Event EType;
+
+static EType Log[EVENTLOG_SIZE];
+static volatile unsigned long PutI;	// written by FSM only
+static volatile unsigned long GetI;	// written by UART0_Handler only
+unsigned long EventLog_Dropped;
+
+static unsigned char Frame[8];			// frame being drained
+static unsigned long FrameI;				// next byte of Frame to send, 8 is none
+
+static char Text[EVENTLOG_TEXTSIZE];
+static volatile unsigned long TextPut;	// written by EventLog_Text only
+static volatile unsigned long TextGet;	// written by UART0_Handler only
+static int InText;									// 1 while a text line is half sent
+
+//------------EventLog_Init------------
+// Start the free-running timestamp timer (Timer1A) and
+// arm the UART0 transmit interrupt at the lowest priority.
+// UART_Init() must be called first.
+// Input: none
+// Output: none
+void EventLog_Init(void){ volatile unsigned long delay;
+	PutI = GetI = 0;
+	FrameI = 8;
+	TextPut = TextGet = 0;
+	InText = 0;
+	EventLog_Dropped = 0;
+	SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;	// activate Timer1
+	delay = SYSCTL_RCGCTIMER_R;				// for clock to be stable
+	TIMER1_CTL_R = 0;									// disable Timer1A during setup
+	TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;
+																		// periodic, counting up from 0
+	TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD|TIMER_TAMR_TACDIR;
+	TIMER1_TAILR_R = 0xFFFFFFFF;			// full 32-bit range
+	TIMER1_TAPR_R = 0;								// bus clock resolution
+	TIMER1_IMR_R = 0;									// no interrupts, timestamp only
+	TIMER1_CTL_R = TIMER_CTL_TAEN;		// enable Timer1A
+
+																		// TX interrupt when FIFO <= 1/8 full
+	UART0_IFLS_R = (UART0_IFLS_R&~UART_IFLS_TX_M)+UART_IFLS_TX1_8;
+	UART0_IM_R &= ~UART_IM_TXIM;			// armed by the handler when needed
+																		// priority 7, bits 15-13
+	NVIC_PRI1_R = (NVIC_PRI1_R&0xFFFF00FF)|0x0000E000;
+	NVIC_EN0_R = 1<<UART0_IRQ;				// enable interrupt 5 in NVIC
+}
+
+//------------EventLog_Record------------
+// Log one state transition, about 30 bus cycles, never blocks
+// Input: old    state that just finished (0 to 15)
+//        new    next state (0 to 15)
+//        input  sensor input read at the end of old
+// Output: none
+void EventLog_Record(unsigned long old, unsigned long new, unsigned long input){
+	EType *pt;
+	if((PutI - GetI) >= EVENTLOG_SIZE){
+		EventLog_Dropped++;							// ring full, drain is behind
+		return;
+	}
+	pt = &Log[PutI & EVENTLOG_MASK];
+	pt->Time = TIMER1_TAR_R;
+	pt->Info = (old<<12)|(new<<8)|input;
+	PutI = PutI + 1;									// publish after the slot is written
+	NVIC_SW_TRIG_R = UART0_IRQ;				// wake up the drain
+}
+
+//------------EventLog_Text------------
+// Queue one line of text for the drain, whole or not at all.
+// The drain sends a line between two frames and does not
+// start a frame until the line is out.  One producer only,
+// from thread mode, never blocks.
+// Input: line  null-terminated, ends in '\n', shorter than
+//              EVENTLOG_TEXTSIZE
+// Output: 1 if queued, 0 if there is no room yet
+int EventLog_Text(const char *line){
+	unsigned long n, i;
+	n = 0;
+	while(line[n]){
+		n = n + 1;
+	}
+	if((EVENTLOG_TEXTSIZE - (TextPut - TextGet)) < n){
+		return 0;
+	}
+	for(i=0; i<n; i++){
+		Text[(TextPut + i)&TEXT_MASK] = line[i];
+	}
+	TextPut = TextPut + n;						// publish after the bytes are written
+	NVIC_SW_TRIG_R = UART0_IRQ;				// wake up the drain
+	return 1;
+}
+
+// loads the oldest event into Frame, 0 if the ring is empty
+static int LoadFrame(void){
+	EType *pt;
+	unsigned long i, sum;
+	if(GetI == PutI){
+		return 0;
+	}
+	pt = &Log[GetI & EVENTLOG_MASK];
+	Frame[0] = EVENTLOG_SYNC;
+	Frame[1] = (pt->Info>>8)&0xFF;		// old state, new state
+	Frame[2] = pt->Info&0xFF;					// input
+	Frame[3] = pt->Time&0xFF;
+	Frame[4] = (pt->Time>>8)&0xFF;
+	Frame[5] = (pt->Time>>16)&0xFF;
+	Frame[6] = (pt->Time>>24)&0xFF;
+	GetI = GetI + 1;									// slot is free once copied
+	sum = 0;
+	for(i=1; i<7; i++){
+		sum = sum + Frame[i];
+	}
+	Frame[7] = sum&0xFF;
+	FrameI = 0;
+	return 1;
+}
+
+// Lowest priority drain, runs on software trigger from
+// EventLog_Record() or EventLog_Text() and on TX FIFO <= 1/8 full.
+// Between frames events go first, but a text line once
+// started is finished before the next frame.
+void UART0_Handler(void){
+	char c;
+	UART0_ICR_R = UART_ICR_TXIC;			// acknowledge TX FIFO interrupt
+	while((UART0_FR_R&UART_FR_TXFF) == 0){
+		if(FrameI == 8){
+			if(InText || (LoadFrame() == 0)){
+				if(TextGet == TextPut){
+					if(InText){
+						InText = 0;							// line without '\n', let frames go
+						continue;
+					}
+					break;										// nothing left to send
+				}
+				c = Text[TextGet&TEXT_MASK];
+				TextGet = TextGet + 1;
+				InText = (c != '\n');
+				UART0_DR_R = c;
+				continue;
+			}
+		}
+		UART0_DR_R = Frame[FrameI];
+		FrameI = FrameI + 1;
+	}
+	if((FrameI == 8) && (GetI == PutI) && (TextGet == TextPut)){
+		UART0_IM_R &= ~UART_IM_TXIM;		// idle until the next event
+	} else{
+		UART0_IM_R |= UART_IM_TXIM;			// come back when FIFO drains
+	}
+}
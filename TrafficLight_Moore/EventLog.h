@@ -0,0 +1,51 @@
+// EventLog.h
+// Runs on LM4F120/TM4C123
+// Timestamped state-transition log for the traffic light FSM.
+// The FSM is the single producer, it drops compact binary
+// events into a lock-free ring buffer.  The lowest priority
+// UART0 interrupt is the single consumer, it drains the
+// ring over UART0 in the background.  Text lines, such as
+// the statistics dump, go through the same drain so frames
+// and text never split each other on the wire.
+// Enes Kur
+// October 18, 2026
+
+// Frame on the wire, 8 bytes per event
+// byte 0    0xA5 sync
+// byte 1    old state (bits 7-4), new state (bits 3-0)
+// byte 2    sensor input that selected Fsm[old].Next[input]
+// byte 3-6  timestamp, bus cycles, little endian, wraps every 53.7 s at 80 MHz
+// byte 7    checksum, sum of bytes 1-6 modulo 256
+// Host/EventDecode.c reads the stream back into a timeline.
+
+#define EVENTLOG_SIZE 64				// events in the ring, must be a power of 2
+#define EVENTLOG_TEXTSIZE 256		// text bytes waiting for the drain, power of 2
+#define EVENTLOG_SYNC 0xA5
+
+extern unsigned long EventLog_Dropped;	// events lost because the ring was full
+
+//------------EventLog_Init------------
+// Start the free-running timestamp timer (Timer1A) and
+// arm the UART0 transmit interrupt at the lowest priority.
+// UART_Init() must be called first.
+// Input: none
+// Output: none
+void EventLog_Init(void);
+
+//------------EventLog_Record------------
+// Log one state transition, about 30 bus cycles, never blocks
+// Input: old    state that just finished (0 to 15)
+//        new    next state (0 to 15)
+//        input  sensor input read at the end of old
+// Output: none
+void EventLog_Record(unsigned long old, unsigned long new, unsigned long input);
+
+//------------EventLog_Text------------
+// Queue one line of text for the drain, whole or not at all.
+// The drain sends a line between two frames and does not
+// start a frame until the line is out.  One producer only,
+// from thread mode, never blocks.
+// Input: line  null-terminated, ends in '\n', shorter than
+//              EVENTLOG_TEXTSIZE
+// Output: 1 if queued, 0 if there is no room yet
+int EventLog_Text(const char *line);
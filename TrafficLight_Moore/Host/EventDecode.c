@@ -0,0 +1,95 @@
+// EventDecode.c
+// Runs on the host PC, not on the LaunchPad
+// Decodes the binary state-transition stream written by
+// EventLog.c on the TrafficLight UART0 and prints a timeline.
+// Enes Kur
+// October 18, 2026
+
+// Build: cc -o EventDecode EventDecode.c
+// Usage: EventDecode [capture.bin] [bus clock in Hz]
+// Capture the COM port raw at 115200 8N1 into a file, or pipe
+// it in on stdin.  The bus clock defaults to 80 MHz.
+// Output, one line per transition:
+//   time_s,old,new,input,dwell_s
+// Bytes that do not form a valid frame (text from the
+// statistics dump, line noise) are skipped by resynchronizing
+// on the sync byte and checksum.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SYNC 0xA5
+#define FRAMESIZE 8
+
+static const char *Names[16] = {
+	"EO", "EW", "NO", "NW", "WO", "WH1", "WC1", "WH2", "WC2", "WH3",
+	"?10", "?11", "?12", "?13", "?14", "?15"
+};
+
+// checks sync byte and checksum of an 8-byte frame
+static int FrameValid(const unsigned char *f){
+	unsigned int i, sum;
+	if(f[0] != SYNC){
+		return 0;
+	}
+	sum = 0;
+	for(i=1; i<7; i++){
+		sum = sum + f[i];
+	}
+	return ((sum&0xFF) == f[7]);
+}
+
+int main(int argc, char **argv){
+	FILE *in;
+	double clock;
+	unsigned char f[FRAMESIZE];
+	unsigned int n, i;
+	unsigned long stamp, last, skipped, frames;
+	unsigned long long wraps, now, prev;
+	int c, first;
+
+	in = stdin;
+	if((argc > 1) && ((in = fopen(argv[1], "rb")) == NULL)){
+		perror(argv[1]);
+		return 1;
+	}
+	clock = (argc > 2) ? atof(argv[2]) : 80000000.0;
+	n = 0; first = 1; wraps = 0; last = 0; prev = 0;
+	skipped = 0; frames = 0;
+	printf("time_s,old,new,input,dwell_s\n");
+	while((c = fgetc(in)) != EOF){
+		f[n] = (unsigned char)c;
+		n = n + 1;
+		if(n < FRAMESIZE){
+			continue;
+		}
+		if(!FrameValid(f)){
+			// slide one byte and look for the next sync
+			for(i=1; i<FRAMESIZE; i++){
+				f[i-1] = f[i];
+			}
+			n = FRAMESIZE-1;
+			skipped = skipped + 1;
+			continue;
+		}
+		n = 0;
+		frames = frames + 1;
+		stamp = f[3] | (f[4]<<8) | ((unsigned long)f[5]<<16) | ((unsigned long)f[6]<<24);
+		// the 32-bit timer wraps every 2^32 cycles, states last
+		// well under that, so a smaller stamp means one wrap
+		if(!first && (stamp < last)){
+			wraps = wraps + 1;
+		}
+		now = (wraps<<32) + stamp;
+		printf("%.6f,%s,%s,%u,%.6f\n", now/clock, Names[f[1]>>4], Names[f[1]&0x0F],
+			f[2], first ? 0.0 : (now-prev)/clock);
+		first = 0;
+		last = stamp;
+		prev = now;
+	}
+	fprintf(stderr, "%lu frames, %lu bytes skipped\n", frames, skipped);
+	if(in != stdin){
+		fclose(in);
+	}
+	return 0;
+}
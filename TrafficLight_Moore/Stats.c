@@ -0,0 +1,249 @@
+// Stats.c
+// Runs on LM4F120/TM4C123
+// Runtime statistics for the traffic light Moore FSM.
+// Counts visits and cumulative time per state, keeps a
+// transition-count matrix over Fsm[].Next and tracks the
+// longest wait seen on each sensor input line.
+// Tables are exported over UART0 on request, the data is
+// used to tune longWait/shortWait against real traffic.
+// Enes Kur
+// October 18, 2026
+
+#include "Stats.h"
+#include "UART.h"
+#include "EventLog.h"
+#include "..//Common/AO.h"
+
+unsigned long Stats_Visits[STATS_NUMSTATES];
+unsigned long Stats_Time[STATS_NUMSTATES];
+unsigned long Stats_Trans[STATS_NUMSTATES][STATS_NUMSTATES];
+unsigned long Stats_MaxWait[STATS_NUMINPUTS];
+
+static unsigned long Current;									// state being timed
+static unsigned long Now;											// 10 ms ticks since init
+static unsigned long Serve[STATS_NUMINPUTS];	// state serving each input line
+static unsigned long Waiting;									// bit i set, line i is waiting
+static unsigned long WaitStart[STATS_NUMINPUTS];	// tick the wait began
+static char Line[128];												// export row being built
+static int Exporting;													// 1 while a dump is going out
+static unsigned long Cursor;									// next row of the dump
+
+// closes the wait on input line i and keeps the longest one
+static void EndWait(unsigned long i){
+	unsigned long wait;
+	wait = Now - WaitStart[i];
+	if(wait > Stats_MaxWait[i]){
+		Stats_MaxWait[i] = wait;
+	}
+	Waiting &= ~(1<<i);
+}
+
+//------------Stats_Init------------
+// Clear all tables and start counting in the initial state
+// Input: initial  state the FSM starts in
+//        serve    serve[i] is the state that gives the right
+//                 of way to input line i
+// Output: none
+void Stats_Init(unsigned long initial, const unsigned long serve[STATS_NUMINPUTS]){
+	unsigned long i, j;
+	for(i=0; i<STATS_NUMSTATES; i++){
+		Stats_Visits[i] = 0;
+		Stats_Time[i] = 0;
+		for(j=0; j<STATS_NUMSTATES; j++){
+			Stats_Trans[i][j] = 0;
+		}
+	}
+	for(i=0; i<STATS_NUMINPUTS; i++){
+		Stats_MaxWait[i] = 0;
+		Serve[i] = serve[i];
+	}
+	Waiting = 0;
+	Now = 0;
+	Current = initial;
+	Stats_Visits[initial] = 1;		// the first state counts as a visit
+}
+
+//------------Stats_Tick------------
+// Account one 10 ms period in the current state and follow
+// how long each asserted sensor has been waiting
+// Input: input  sensor lines, bit i is input line i
+// Output: none
+void Stats_Tick(unsigned long input){
+	unsigned long i;
+	Now++;
+	Stats_Time[Current]++;
+	for(i=0; i<STATS_NUMINPUTS; i++){
+		if(Waiting & (1<<i)){
+			if((input & (1<<i)) == 0){
+				EndWait(i);							// car left or pedestrian gave up
+			}
+		}
+		else if((input & (1<<i)) && (Current != Serve[i])){
+			Waiting |= (1<<i);				// new request, not being served
+			WaitStart[i] = Now;
+		}
+	}
+}
+
+//------------Stats_Transition------------
+// Record a state change taken through Fsm[from].Next[input]
+// Input: from  state that just finished
+//        to    next state
+// Output: none
+void Stats_Transition(unsigned long from, unsigned long to){
+	unsigned long i;
+	Stats_Trans[from][to]++;
+	Stats_Visits[to]++;
+	Current = to;
+	for(i=0; i<STATS_NUMINPUTS; i++){
+		if((Waiting & (1<<i)) && (Serve[i] == to)){
+			EndWait(i);								// request got the right of way
+		}
+	}
+}
+
+// copies a string to pt, returns the end
+static char *Str(char *pt, const char *s){
+	while(*s){
+		*pt++ = *s++;
+	}
+	return pt;
+}
+
+// writes n in decimal to pt, returns the end
+static char *Dec(char *pt, unsigned long n){
+	char digits[10];
+	unsigned long i;
+	i = 0;
+	do{
+		digits[i++] = '0' + n%10;
+		n = n/10;
+	} while(n);
+	while(i){
+		*pt++ = digits[--i];
+	}
+	return pt;
+}
+
+// Builds row r of the export in Line, 0 past the last row
+static int Row(unsigned long r){
+	char *pt;
+	unsigned long j;
+	pt = Line;
+	if(r == 0){
+		pt = Str(pt, "state,visits,time");
+	}
+	else if((r = r - 1) < STATS_NUMSTATES){
+		pt = Dec(pt, r);
+		*pt++ = ',';
+		pt = Dec(pt, Stats_Visits[r]);
+		*pt++ = ',';
+		pt = Dec(pt, Stats_Time[r]);
+	}
+	else if((r = r - STATS_NUMSTATES) == 0){
+		pt = Str(pt, "trans");
+		for(j=0; j<STATS_NUMSTATES; j++){
+			*pt++ = ',';
+			pt = Dec(pt, j);
+		}
+	}
+	else if((r = r - 1) < STATS_NUMSTATES){
+		pt = Dec(pt, r);
+		for(j=0; j<STATS_NUMSTATES; j++){
+			*pt++ = ',';
+			pt = Dec(pt, Stats_Trans[r][j]);
+		}
+	}
+	else if((r = r - STATS_NUMSTATES) == 0){
+		pt = Str(pt, "input,maxwait");
+	}
+	else if((r = r - 1) < STATS_NUMINPUTS){
+		pt = Dec(pt, r);
+		*pt++ = ',';
+		pt = Dec(pt, Stats_MaxWait[r]);
+	}
+	else if((r = r - STATS_NUMINPUTS) == 0){
+		pt = Str(pt, "object,load,maxcycles");
+	}
+	else if((r = r - 1) < STATS_NUMOBJECTS){
+		pt = Dec(pt, r);
+		*pt++ = ',';
+		pt = Dec(pt, AO_Load[r]);
+		*pt++ = ',';
+		pt = Dec(pt, AO_MaxCycles[r]);
+	}
+	else if((r = r - STATS_NUMOBJECTS) == 0){
+		pt = Str(pt, "idle,");
+		pt = Dec(pt, AO_IdleLoad);
+	}
+	else if(r == 1){
+		pt = Str(pt, "lost,poolmin");
+	}
+	else if(r == 2){
+		pt = Dec(pt, AO_Lost);
+		*pt++ = ',';
+		pt = Dec(pt, AO_PoolMin);
+	}
+	else{
+		return 0;
+	}
+	pt = Str(pt, "\r\n");
+	*pt = 0;
+	return 1;
+}
+
+//------------Stats_Poll------------
+// Non-blocking check of the UART for a request, and queues
+// the next rows of a running dump while the text ring has
+// room.  'r' clears the tables, any other character dumps them.
+// Input: none
+// Output: none
+void Stats_Poll(void){
+	unsigned char cmd;
+	cmd = UART_InCharNonBlocking();
+	if(cmd == 'r'){
+		Stats_Init(Current, Serve);
+		EventLog_Text("reset\r\n");
+	}
+	else if(cmd){
+		Stats_Export();
+	}
+	while(Exporting){
+		if(Row(Cursor) == 0){
+			Exporting = 0;							// last row queued
+		}
+		else if(EventLog_Text(Line)){
+			Cursor = Cursor + 1;
+		}
+		else{
+			break;										// ring full, go on next poll
+		}
+	}
+}
+
+//------------Stats_Export------------
+// Start printing all tables over UART0 as comma-separated
+// text.  Returns at once, Stats_Poll() queues the rows to the
+// event log drain (EventLog_Text) as it frees room, a dump
+// takes a few polls and rows are read as they are queued.
+// Input: none
+// Output: none
+// Example (10 states, 3 inputs, times in 10 ms units)
+//   state,visits,time
+//   0,12,3600
+//   ...
+//   trans,0,1,2,...,9
+//   0,5,7,0,...,0
+//   ...
+//   input,maxwait
+//   0,375
+//   object,load,maxcycles    (load in 0.1 %, in AO_Start order)
+//   0,2,1840
+//   ...
+//   idle,988
+//   lost,poolmin    (events dropped, fewest free event blocks)
+//   0,29
+void Stats_Export(void){
+	Cursor = 0;
+	Exporting = 1;
+}
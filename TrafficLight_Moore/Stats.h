@@ -0,0 +1,59 @@
+// Stats.h
+// Runs on LM4F120/TM4C123
+// Runtime statistics for the traffic light Moore FSM.
+// Counts visits and cumulative time per state, keeps a
+// transition-count matrix over Fsm[].Next and tracks the
+// longest wait seen on each sensor input line.
+// Tables are exported over UART0 on request, with the CPU
+// share and event counters of the active objects.
+// Enes Kur
+// October 18, 2026
+
+#define STATS_NUMSTATES 10			// number of states in Fsm[]
+#define STATS_NUMINPUTS 3				// PE0 east car, PE1 north car, PE2 pedestrian
+#define STATS_NUMOBJECTS 2			// active objects, light FSM and reporter
+
+extern unsigned long Stats_Visits[STATS_NUMSTATES];	// times each state was entered
+extern unsigned long Stats_Time[STATS_NUMSTATES];		// 10 ms ticks spent in each state
+																										// [from][to] transition counts
+extern unsigned long Stats_Trans[STATS_NUMSTATES][STATS_NUMSTATES];
+extern unsigned long Stats_MaxWait[STATS_NUMINPUTS];	// longest wait per input, 10 ms units
+
+//------------Stats_Init------------
+// Clear all tables and start counting in the initial state
+// Input: initial  state the FSM starts in
+//        serve    serve[i] is the state that gives the right
+//                 of way to input line i
+// Output: none
+void Stats_Init(unsigned long initial, const unsigned long serve[STATS_NUMINPUTS]);
+
+//------------Stats_Tick------------
+// Account one 10 ms period in the current state and follow
+// how long each asserted sensor has been waiting
+// Input: input  sensor lines, bit i is input line i
+// Output: none
+void Stats_Tick(unsigned long input);
+
+//------------Stats_Transition------------
+// Record a state change taken through Fsm[from].Next[input]
+// Input: from  state that just finished
+//        to    next state
+// Output: none
+void Stats_Transition(unsigned long from, unsigned long to);
+
+//------------Stats_Poll------------
+// Non-blocking check of the UART for a request, and queues
+// the next rows of a running dump while the text ring has
+// room.  'r' clears the tables, any other character dumps them.
+// Input: none
+// Output: none
+void Stats_Poll(void);
+
+//------------Stats_Export------------
+// Start printing all tables over UART0 as comma-separated
+// text.  Returns at once, Stats_Poll() queues the rows to the
+// event log drain (EventLog_Text) as it frees room, a dump
+// takes a few polls and rows are read as they are queued.
+// Input: none
+// Output: none
+void Stats_Export(void);
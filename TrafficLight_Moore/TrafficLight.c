@@ -2,6 +2,10 @@
 // TrafficLight.c
 // Runs on LM4F120/TM4C123
 // Index implementation of a Moore finite state machine to operate a traffic light.  
+// The FSM is an active object (Common/AO.h) instead of
+// busy-waiting on SysTick: a periodic software timer
+// (Common/SoftTimer.h) posts it a tick every 10 ms, a second
+// object serves the statistics requests every 100 ms.
 // Enes Kur
 // June 26, 2022
 
@@ -29,6 +33,12 @@
 
 // ***** 1. Pre-processor Directives Section *****
 #include "tm4c123gh6pm.h"
+#include "UART.h"
+#include "Stats.h"
+#include "EventLog.h"
+#include "..//Common/Clock.h"
+#include "..//Common/AO.h"
+#include "..//Common/SoftTimer.h"
 #define EO 		0								// East open
 #define EW 		1								// East yellow
 #define NO 		2								// North open
@@ -41,18 +51,18 @@
 #define WH3 	9								// Peds third and last red
 #define shortWait 75					// 750 msec
 #define longWait 300					// 3000 msec
+#define SIG_TICK 1						// to Light, 10 ms passed
+#define SIG_POLL 2						// to Reporter, check for a request
 // ***** 2. Global Declarations Section *****
 
 // FUNCTION PROTOTYPES: Each subroutine defined
 void DisableInterrupts(void); // Disable interrupts
 void EnableInterrupts(void);  // Enable interrupts
 void Ports_Init(void);				// Init ports B, E and F
-void SysTick_Init(void);			// Init SysTick
-															// 10 ms wait func
-void SysTick_Wait10ms(unsigned long delay);
-															// 1 ms wait func
-void SysTick_Wait(unsigned long delay);
-void PLL_Init(void);					// 80 MHz clock
+void Light_Dispatch(const struct AO_Event *e);		// FSM, SIG_TICK every 10 ms
+void Reporter_Dispatch(const struct AO_Event *e);	// statistics, SIG_POLL every 100 ms
+void LightTick(void);					// SoftTimer tasks, post the time events
+void PollTick(void);
 
 															// Traffic Lights Output(LEDs)
 void LightOut(unsigned long output);
@@ -89,23 +99,67 @@ SType Fsm[10] = {
 unsigned long CState;					// Current state
 unsigned long Input;					// from sensors(buttons)
 unsigned long Output;					// to traffic lights(LEDs)
+unsigned long Remain;					// 10 ms periods left in the current state
+
+															// State that serves each sensor line
+															// PE0 east car, PE1 north car, PE2 pedestrian
+const unsigned long Serve[STATS_NUMINPUTS] = {EO, NO, WO};
+
+															// Active objects, Light has priority
+struct AO_Object Light;
+struct AO_Event *LightQueue[4];
+struct AO_Object Reporter;
+struct AO_Event *ReporterQueue[2];
+struct SoftTimer LightTimer;	// SIG_TICK time event
+struct SoftTimer PollTimer;		// SIG_POLL time event
 
 // ***** 3. Subroutines Section *****
 
 int main(void){ 
-  PLL_Init();									// Activates 80 MHz clock
+  Clock_Init();								// Activates 80 MHz clock
   Ports_Init();								// Activates ports B, E and F
-	SysTick_Init();							// Activates SysTick
+	UART_Init();								// Activates UART0 for statistics export
 	CState = NO;								// North open by default
-  EnableInterrupts();  				// enable after all initialization are done
-	while(1){
-		LightOut(CState);					// Outputs current state
-															// Waits on that state
-		SysTick_Wait10ms(Fsm[CState].Time);
-		Input = SensorIn();				// Gets input
+	Stats_Init(CState, Serve);	// Clears runtime statistics
+	EventLog_Init();						// Starts timestamps and background UART drain
+	LightOut(CState);						// Outputs first state
+	Remain = Fsm[CState].Time;
+	AO_Init();
+	AO_Start(&Light, &Light_Dispatch, LightQueue, 4);
+	AO_Start(&Reporter, &Reporter_Dispatch, ReporterQueue, 2);
+	SoftTimer_Init();						// 1 ms tick on Timer2A
+	SoftTimer_Start(&LightTimer, 10, 10, &LightTick);
+	SoftTimer_Start(&PollTimer, 5, 100, &PollTick);	// between two light steps
+	AO_Run();										// enables interrupts, never returns
+}
+
+// Time events, run in the SoftTimer tick
+void LightTick(void){
+	AO_Post(&Light, SIG_TICK, 0);
+}
+void PollTick(void){
+	AO_Post(&Reporter, SIG_POLL, 0);
+}
+
+// Serves 'r' and dump requests from the UART
+void Reporter_Dispatch(const struct AO_Event *e){
+	Stats_Poll();
+}
+
+// Waits Fsm[CState].Time ticks of 10 ms in each state, then
+// reads the sensors and moves to the next state
+void Light_Dispatch(const struct AO_Event *e){
+	Input = SensorIn();					// one reading for the statistics and the step
+	Stats_Tick(Input);					// time in state and sensor waits
+	Remain--;
+	if(Remain == 0){
 															// Switches to next state
+		Stats_Transition(CState, Fsm[CState].Next[Input]);
+		EventLog_Record(CState, Fsm[CState].Next[Input], Input);
 		CState = Fsm[CState].Next[Input];
-  }
+		LightOut(CState);					// Outputs current state
+		Remain = Fsm[CState].Time;
+	}
 }
 
 void Ports_Init(void) {
@@ -143,43 +197,3 @@ unsigned long SensorIn(void){
 															// Input from Port E
 	return (GPIO_PORTE_DATA_R & 0x07);
 }
-
-void SysTick_Init(void){
-	NVIC_ST_CTRL_R = 0;         // disable SysTick during setup
-  NVIC_ST_CTRL_R = 0x00000005;// enable SysTick with core clock
-}
-
-void SysTick_Wait10ms(unsigned long delay){
-	unsigned long i;
-  for(i=0; i<delay; i++){
-    SysTick_Wait(800000);  		// wait 10ms
-  }
-}
-
-void SysTick_Wait(unsigned long delay){
-	NVIC_ST_RELOAD_R = delay-1;  // number of counts to wait
-  NVIC_ST_CURRENT_R = 0;       // any value written to CURRENT clears
-  while((NVIC_ST_CTRL_R&0x00010000)==0){ // wait for count flag
-  }
-}
-
-void PLL_Init(void){
-  // 0) Use RCC2
-  SYSCTL_RCC2_R |=  0x80000000;  // USERCC2
-  // 1) bypass PLL while initializing
-  SYSCTL_RCC2_R |=  0x00000800;  // BYPASS2, PLL bypass
-  // 2) select the crystal value and oscillator source
-  SYSCTL_RCC_R = (SYSCTL_RCC_R &~0x000007C0)   // clear XTAL field, bits 10-6
-                 + 0x00000540;   // 10101, configure for 16 MHz crystal
-  SYSCTL_RCC2_R &= ~0x00000070;  // configure for main oscillator source
-  // 3) activate PLL by clearing PWRDN
-  SYSCTL_RCC2_R &= ~0x00002000;
-  // 4) set the desired system divider
-  SYSCTL_RCC2_R |= 0x40000000;   // use 400 MHz PLL
-  SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~ 0x1FC00000)  // clear system clock divider
-                  + (4<<22);      // configure for 80 MHz clock ( writes on SYSDIV2 feild )
-  // 5) wait for the PLL to lock by polling PLLLRIS
-  while((SYSCTL_RIS_R&0x00000040)==0){};  // wait for PLLRIS bit
-  // 6) enable use of PLL by clearing BYPASS
-  SYSCTL_RCC2_R &= ~0x00000800;
-}
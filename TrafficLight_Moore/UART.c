@@ -0,0 +1,75 @@
+// UART.c
+// Runs on LM4F120/TM4C123
+// Simple device driver for the UART0 on PA1-0, which is
+// connected to the virtual COM port of the LaunchPad.
+// Non-blocking input; output goes through the EventLog
+// drain (EventLog_Text), the only writer of UART0.
+// Enes Kur
+// October 18, 2026
+
+/* This example accompanies the book and the course
+   "Embedded Systems: Introduction to ARM Cortex M Microcontrollers",
+   ISBN: 978-1469998749, Jonathan Valvano, copyright (c) 2015
+
+   Copyright 2016 by Jonathan W. Valvano, valvano@mail.utexas.edu
+*/
+
+// U0Rx (VCP receive) connected to PA0
+// U0Tx (VCP transmit) connected to PA1
+
+#include "UART.h"
+#include "..//tm4c123gh6pm.h"
+#include "..//Common/Clock.h"
+
+// Set the divisor for 115,200 baud, 64 times BRD = 4*hz/baud,
+// IBRD is the integer part and FBRD the 6 fraction bits
+static void setbaud(unsigned long hz){
+  unsigned long div;
+  div = (hz*4 + 57600)/115200;
+  UART0_IBRD_R = div>>6;
+  UART0_FBRD_R = div&0x3F;
+                                        // 8 bit word length (no parity bits, one stop bit, FIFOs)
+  UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN);	// also latches IBRD, FBRD
+}
+
+// Keep the baud rate across a clock change
+static void rebaud(unsigned long hz, unsigned long oldhz){
+  UART0_CTL_R &= ~UART_CTL_UARTEN;
+  setbaud(hz);
+  UART0_CTL_R |= UART_CTL_UARTEN;
+}
+
+//------------UART_Init------------
+// Initialize the UART for 115,200 baud rate (any bus clock),
+// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
+// Input: none
+// Output: none
+void UART_Init(void){ unsigned long delay;
+  SYSCTL_RCGC1_R |= SYSCTL_RCGC1_UART0; // activate UART0
+  SYSCTL_RCGC2_R |= SYSCTL_RCGC2_GPIOA; // activate port A
+	delay = SYSCTL_RCGC2_R;								// for clock to be stable
+  UART0_CTL_R &= ~UART_CTL_UARTEN;      // disable UART
+																				// IBRD = int(80,000,000 / (16 * 115200)) = int(43.402778)
+																				// FBRD = round(0.402778 * 64) = 26
+  setbaud(Clock_Hz());
+  UART0_CTL_R |= UART_CTL_UARTEN;       // enable UART
+  Clock_AddListener(&rebaud);
+  GPIO_PORTA_AFSEL_R |= 0x03;           // enable alt funct on PA1-0
+  GPIO_PORTA_DEN_R |= 0x03;             // enable digital I/O on PA1-0
+                                        // configure PA1-0 as UART
+  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFFFFFF00)+0x00000011;
+  GPIO_PORTA_AMSEL_R &= ~0x03;          // disable analog functionality on PA
+}
+
+//------------UART_InCharNonBlocking------------
+// Get oldest serial port input and return immediately
+// if there is no data.
+// Input: none
+// Output: ASCII code for key typed or 0 if no character
+unsigned char UART_InCharNonBlocking(void){
+  if((UART0_FR_R&UART_FR_RXFE) == 0){
+    return((unsigned char)(UART0_DR_R&0xFF));
+  } else{
+    return 0;
+  }
+}
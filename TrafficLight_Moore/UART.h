@@ -0,0 +1,25 @@
+// UART.h
+// Runs on LM4F120/TM4C123
+// Simple device driver for the UART0 on PA1-0, which is
+// connected to the virtual COM port of the LaunchPad.
+// Non-blocking input; output goes through the EventLog
+// drain (EventLog_Text), the only writer of UART0.
+// Enes Kur
+// October 18, 2026
+
+// U0Rx (VCP receive) connected to PA0
+// U0Tx (VCP transmit) connected to PA1
+
+//------------UART_Init------------
+// Initialize the UART for 115,200 baud rate (any bus clock),
+// 8 bit word length, no parity bits, one stop bit, FIFOs enabled
+// Input: none
+// Output: none
+void UART_Init(void);
+
+//------------UART_InCharNonBlocking------------
+// Get oldest serial port input and return immediately
+// if there is no data.
+// Input: none
+// Output: ASCII code for key typed or 0 if no character
+unsigned char UART_InCharNonBlocking(void);
@@ -7,6 +7,14 @@
 // The volume-limiting resistor can be any value from 680 to 2000 ohms
 // The tone is initially off, when the switch goes from
 // not touched to touched, the tone toggles on/off.
+// The switch is an active object (Common/AO.h): a rising
+// edge on PA3 interrupts and posts a press, the switch object
+// toggles the tone, and the CPU sleeps in between.  After a
+// press a software timer (Common/SoftTimer.h) samples PA3 every
+// 1 ms and arms the edge again only when the switch has read
+// released for 10 ms, so neither the press nor the release
+// bounce, however long the key is held, toggles again.  SysTick only
+// makes the tone and runs only while the tone is on.
 //                   |---------|               |---------|     
 // Switch   ---------|         |---------------|         |------
 //
@@ -26,9 +34,20 @@
 */
 
 #include "..//tm4c123gh6pm.h"
+#include "..//Common/Clock.h"
+#include "..//Common/AO.h"
+#include "..//Common/SoftTimer.h"
 
 // Global variables for wave status
-unsigned long WaveStatus, CStatusPrev;
+unsigned long WaveStatus;
+struct SoftTimer Holdoff;				// PA3 stays disarmed while it runs
+unsigned long LowCount;					// 1 ms samples PA3 has read released
+
+#define SIG_PRESS 1							// to Switch, PA3 went from 0 to 1
+#define HOLDOFF 10							// ms PA3 must read released
+
+struct AO_Object Switch;
+struct AO_Event *SwitchQueue[2];
 
 // basic functions defined at end of startup.s
 void DisableInterrupts(void); 	// Disable interrupts
@@ -36,14 +55,13 @@ void EnableInterrupts(void);  	// Enable interrupts
 
 // pre-defined functions
 void WaitForInterrupt(void);  	// low power mode
-void PLL_Init(void);						// 80 MHz clock
+void Switch_Dispatch(const struct AO_Event *e);
 
 // input from PA3, output to PA2, SysTick interrupts
 void Sound_Init(void){ 
 	unsigned long delay;					// dummy 
 	SYSCTL_RCGC2_R |= 0x01;				// Enable PortA Clock
 	WaveStatus = 0;								// 1: Output Wave, 0: Do not output
-	CStatusPrev = 0;							// Holds the previous switch condition
 	delay = SYSCTL_RCGC2_R;				// For Clock to be stable
 	GPIO_PORTA_AFSEL_R &= ~0x0C;	// Disable alt funct
 	GPIO_PORTA_AMSEL_R &= ~0x0C;	// Disable analog mode
@@ -53,33 +71,64 @@ void Sound_Init(void){
 	GPIO_PORTA_DIR_R &= ~0x08;		// Make PA3 input
 	GPIO_PORTA_DR8R_R |= 0x04;		// Allow 8mA current on PA2
 	GPIO_PORTA_DEN_R |= 0x0C;			// Enable digital mode for PA2, PA3
+	GPIO_PORTA_IS_R &= ~0x08;			// PA3 edge-sensitive
+	GPIO_PORTA_IBE_R &= ~0x08;		// one edge
+	GPIO_PORTA_IEV_R |= 0x08;			// rising, not touched to touched
+	GPIO_PORTA_ICR_R = 0x08;			// clear a stale flag
+	GPIO_PORTA_IM_R |= 0x08;			// arm PA3
+																// priority 3, interrupt 0 is bits 7-5
+	NVIC_PRI0_R = (NVIC_PRI0_R & 0xFFFFFF00) | 0x00000060;
+	NVIC_EN0_R = 1<<0;						// enable interrupt 0 in NVIC
 	
 	NVIC_ST_CTRL_R = 0;						// Disable SysTick before init
-	NVIC_ST_RELOAD_R = 90908; 		// 90908 ~ 880Hz
+	NVIC_ST_RELOAD_R = Clock_Scale(90909)-1;	// 90908 ~ 880Hz at 80 MHz
 																// priority: 0
 	NVIC_SYS_PRI3_R = NVIC_SYS_PRI3_R & 0x00FFFFFF;
-	NVIC_ST_CTRL_R = 0x00000007;	// Enable SysTick with interrupt
+																// started by the first press
+	Clock_AddListener(&Clock_RescaleSysTick);	// stays at 880 Hz if the clock changes
+}
+
+// every 1 ms after a press, rearms PA3 once it stays released
+void Rearm(void){
+	if(GPIO_PORTA_DATA_R & 0x08){
+		LowCount = 0;								// still held or bouncing
+		return;
+	}
+	LowCount++;
+	if(LowCount >= HOLDOFF){
+		SoftTimer_Stop(&Holdoff);
+		GPIO_PORTA_ICR_R = 0x08;		// forget the bounces
+		GPIO_PORTA_IM_R |= 0x08;		// rearm PA3
+	}
+}
+
+// PosEdge on PA3, posts the press and stops listening
+// until the bounce is out
+void GPIOPortA_Handler(void){
+	GPIO_PORTA_ICR_R = 0x08;			// acknowledge PA3
+	GPIO_PORTA_IM_R &= ~0x08;			// disarm, bounces follow
+	LowCount = 0;
+	SoftTimer_Start(&Holdoff, 1, 1, &Rearm);
+	AO_Post(&Switch, SIG_PRESS, 0);
+}
+
+// switch object, each press changes output condition
+void Switch_Dispatch(const struct AO_Event *e){
+	// if Wave is on, makes off and vice versa
+	if(WaveStatus == 1){
+		WaveStatus = 0;
+		NVIC_ST_CTRL_R = 0;					// no tone, no SysTick wakeups
+		GPIO_PORTA_DATA_R &= ~0x04;
+	}
+	else{
+		WaveStatus = 1;
+		NVIC_ST_CURRENT_R = 0;
+		NVIC_ST_CTRL_R = 0x00000007;	// Enable SysTick with interrupt
+	}
 }
 
 // called at 880 Hz
-// if Input is PosEdge, changes output condition
 void SysTick_Handler(void){
-	
-	// Check if Input is PosEdge(Current Input is 1, prev is 0)
-	if((GPIO_PORTA_DATA_R & 0x08) == 0x08){
-		// if prev input is 0
-		if(CStatusPrev == 0x00){
-			// if Wave is on, makes off and vice versa
-			if(WaveStatus == 1)
-				WaveStatus = 0;
-			else
-				WaveStatus = 1;
-		}
-	}
-	
-	// Save Input 
-	CStatusPrev = GPIO_PORTA_DATA_R & 0x08;
-	
 	// is Wave is on, toggles Output for 440Hz output, else closes
 	if (WaveStatus == 1){
 		GPIO_PORTA_DATA_R ^= 0x04;
@@ -88,31 +137,12 @@ void SysTick_Handler(void){
 		GPIO_PORTA_DATA_R &= ~0x04;
 }
 
-void PLL_Init(void){
-  // 0) Use RCC2
-  SYSCTL_RCC2_R |=  0x80000000;  // USERCC2
-  // 1) bypass PLL while initializing
-  SYSCTL_RCC2_R |=  0x00000800;  // BYPASS2, PLL bypass
-  // 2) select the crystal value and oscillator source
-  SYSCTL_RCC_R = (SYSCTL_RCC_R &~0x000007C0)   // clear XTAL field, bits 10-6
-                 + 0x00000540;   // 10101, configure for 16 MHz crystal
-  SYSCTL_RCC2_R &= ~0x00000070;  // configure for main oscillator source
-  // 3) activate PLL by clearing PWRDN
-  SYSCTL_RCC2_R &= ~0x00002000;
-  // 4) set the desired system divider
-  SYSCTL_RCC2_R |= 0x40000000;   // use 400 MHz PLL
-  SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~ 0x1FC00000)  // clear system clock divider
-                  + (4<<22);      // configure for 80 MHz clock ( writes on SYSDIV2 field )
-  // 5) wait for the PLL to lock by polling PLLLRIS
-  while((SYSCTL_RIS_R&0x00000040)==0){};  // wait for PLLRIS bit
-  // 6) enable use of PLL by clearing BYPASS
-  SYSCTL_RCC2_R &= ~0x00000800;
-}
-
 int main(void){
-	PLL_Init();									// 80 Mhz clock
+	Clock_Init();								// 80 Mhz clock
   Sound_Init();  							// initialize PA2, PA3
-	EnableInterrupts();					// enabling interrupts after initialization
-  while(1){}
+	SoftTimer_Init();						// 1 ms tick on Timer2A
+	AO_Init();
+	AO_Start(&Switch, &Switch_Dispatch, SwitchQueue, 2);
+	AO_Run();										// enables interrupts, never returns
 }
 